@@ -0,0 +1,128 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+#ifndef ZOIDBOL_ARGUMENTVIEW__HPP
+#define ZOIDBOL_ARGUMENTVIEW__HPP
+/*-
+ * Copyright (c) 2021-current, Terry Mathew Poulin <BigBoss1964@gmail.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+
+namespace zoidbol
+{
+    /** Non owning view of a null terminated argument.
+     *
+     * Provides the read only subset of std::string used by
+     * CommandLineParser, without copying the characters.
+     */
+    class ArgumentView
+    {
+      public:
+        typedef char value_type;
+        typedef std::size_t size_type;
+        typedef const char* const_iterator;
+
+        /** Create a view of the empty string.
+         */
+        ArgumentView()
+            : mData("")
+            , mSize(0)
+        {
+        }
+
+        /** Create a view of a null terminated C string.
+         */
+        ArgumentView(const char* str)
+            : mData(str)
+            , mSize(std::strlen(str))
+        {
+        }
+
+        /** Create a view of str, which must have a null at str[size].
+         */
+        ArgumentView(const char* str, size_type size)
+            : mData(str)
+            , mSize(size)
+        {
+        }
+
+        size_type size() const
+        {
+            return mSize;
+        }
+
+        size_type length() const
+        {
+            return mSize;
+        }
+
+        bool empty() const
+        {
+            return mSize == 0;
+        }
+
+        const char* c_str() const
+        {
+            return mData;
+        }
+
+        const char* data() const
+        {
+            return mData;
+        }
+
+        const char& operator[](size_type pos) const
+        {
+            return mData[pos];
+        }
+
+        const_iterator begin() const
+        {
+            return mData;
+        }
+
+        const_iterator end() const
+        {
+            return mData + mSize;
+        }
+
+      private:
+        const char* mData;
+        size_type mSize;
+    };
+
+    inline bool operator==(const ArgumentView& lhs, const ArgumentView& rhs)
+    {
+        return lhs.size() == rhs.size() && std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+    }
+
+    inline bool operator!=(const ArgumentView& lhs, const ArgumentView& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    inline std::ostream& operator<<(std::ostream& out, const ArgumentView& arg)
+    {
+        return out.write(arg.data(), static_cast<std::streamsize>(arg.size()));
+    }
+
+} // namespace zoidbol
+
+#endif // ZOIDBOL_ARGUMENTVIEW__HPP
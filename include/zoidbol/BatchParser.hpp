@@ -0,0 +1,307 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+#ifndef ZOIDBOL_BATCHPARSER__HPP
+#define ZOIDBOL_BATCHPARSER__HPP
+/*-
+ * Copyright (c) 2021-current, Terry Mathew Poulin <BigBoss1964@gmail.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <zoidbol/OptionSyntax.hpp>
+#include <zoidbol/OptionTable.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace zoidbol
+{
+    /** Parse many argument lists against one shared OptionTable.
+     *
+     * Unlike CommandLineParser nothing is stored in the options and no
+     * callbacks are run: each argument list produces an Invocation record
+     * and a run of Match records. That makes parsing stateless, so parse()
+     * spreads the lists over a pool of threads which claim fixed size
+     * chunks of work from a shared counter until none are left.
+     *
+     * Arguments are matched by OptionSyntax, like CommandLineParser::parse().
+     * Where that would throw a CommandLineError the Invocation records an
+     * Error and parsing of that list stops.
+     */
+    template <class OptionType>
+    class BatchParser
+    {
+      public:
+        typedef OptionTable<OptionType> table_type;
+        typedef typename table_type::index_type index_type;
+
+        static const index_type npos = table_type::npos;
+
+        enum Error {
+            PARSED_OK,        /**< Parsed successfully. */
+            MISSING_ARGUMENT, /**< ARGUMENT_REQUIRED option without a value. */
+        };
+
+        /** One matched option.
+         *
+         * The value, if any, is the null terminated tail of an input
+         * argument: args[value_argument].c_str() + value_offset.
+         */
+        struct Match
+        {
+            index_type option;         /**< Index in the OptionTable. */
+            index_type value_argument; /**< Index in the argument list, or npos if no value. */
+            index_type value_offset;   /**< Offset of the value in that argument. */
+        };
+
+        /** Result for one argument list.
+         */
+        struct Invocation
+        {
+            index_type first_match;   /**< Index of the first Match in Results::matches. */
+            index_type match_count;   /**< Number of Match records. */
+            index_type first_operand; /**< Index of the first non option argument. */
+            index_type operand_count; /**< Number of non option arguments. */
+            std::uint16_t unknown;    /**< Number of flags not in the table. */
+            std::uint8_t error;       /**< Error. */
+            std::uint8_t reserved;
+        };
+
+        struct Results
+        {
+            std::vector<Invocation> invocations;
+            std::vector<Match> matches;
+        };
+
+        /** Number of argument lists claimed by a thread at a time.
+         */
+        static const std::size_t CHUNK_SIZE = 1024;
+
+        /** Create a parser for the options in table.
+         *
+         * The table must outlive the parser and not change while parse()
+         * runs.
+         */
+        BatchParser(const table_type& table)
+            : mTable(table)
+        {
+        }
+
+        /** Parse every argument list in invocations.
+         *
+         * @param invocations random access list of argument lists, e.g.
+         * std::vector<std::vector<std::string>>. Each argument list is
+         * purely arguments, no program name.
+         * @param threads number of threads, 0 for one per hardware thread.
+         * @returns one Invocation per argument list, in order.
+         */
+        template <class InvocationList>
+        Results parse(const InvocationList& invocations, unsigned threads = 0) const
+        {
+            std::size_t count = invocations.size();
+            std::size_t chunks = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+            if (threads == 0)
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            threads = static_cast<unsigned>(std::min<std::size_t>(threads, std::max<std::size_t>(chunks, 1)));
+
+            std::vector<Results> parts(chunks);
+            std::vector<std::size_t> match_offsets(chunks + 1, 0);
+            Results results;
+
+            /* Pass 1: parse each chunk into its own Results. */
+            run(threads, chunks, [&](std::size_t chunk) {
+                Results& part = parts[chunk];
+                std::size_t first = chunk * CHUNK_SIZE;
+                std::size_t last = std::min(first + CHUNK_SIZE, count);
+                part.invocations.reserve(last - first);
+                for (std::size_t i = first; i < last; ++i) {
+                    part.invocations.push_back(parse_one(invocations[i], part.matches));
+                }
+            });
+
+            for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+                match_offsets[chunk + 1] = match_offsets[chunk] + parts[chunk].matches.size();
+            }
+            if (match_offsets[chunks] >= npos)
+                throw std::length_error("zoidbol::BatchParser::parse(): too many matches");
+            results.invocations.resize(count);
+            results.matches.resize(match_offsets[chunks]);
+
+            /* Pass 2: copy the chunks into place. */
+            run(threads, chunks, [&](std::size_t chunk) {
+                Results& part = parts[chunk];
+                index_type offset = static_cast<index_type>(match_offsets[chunk]);
+                Invocation* out = results.invocations.data() + chunk * CHUNK_SIZE;
+                for (std::size_t i = 0; i < part.invocations.size(); ++i) {
+                    out[i] = part.invocations[i];
+                    out[i].first_match += offset;
+                }
+                std::copy(part.matches.begin(), part.matches.end(), results.matches.begin() + offset);
+                std::vector<Invocation>().swap(part.invocations);
+                std::vector<Match>().swap(part.matches);
+            });
+
+            return results;
+        }
+
+        /** Parse a single argument list.
+         *
+         * @param args the argument list, a random access container such as
+         * std::vector<std::string>.
+         * @param matches Match records are appended here.
+         * @returns the Invocation, first_match is relative to matches.
+         */
+        template <class ArgumentList>
+        Invocation parse_one(const ArgumentList& args, std::vector<Match>& matches) const
+        {
+            Invocation result;
+            result.first_match = static_cast<index_type>(matches.size());
+            result.match_count = 0;
+            result.first_operand = static_cast<index_type>(args.size());
+            result.operand_count = 0;
+            result.unknown = 0;
+            result.error = PARSED_OK;
+            result.reserved = 0;
+
+            Matcher<typename ArgumentList::const_iterator> matcher = {mTable, args.begin(), result, matches};
+            OptionSyntax<OptionType>::parse(args.begin(), args.end(), matcher);
+
+            result.match_count = static_cast<index_type>(matches.size() - result.first_match);
+            return result;
+        }
+
+      private:
+        const table_type& mTable;
+
+        /** Run work(chunk) for every chunk in [0, chunks) on threads threads.
+         *
+         * The calling thread is one of them. If a thread cannot be started
+         * the chunks are shared by the ones already running.
+         */
+        template <class Work>
+        static void run(unsigned threads, std::size_t chunks, Work work)
+        {
+            std::atomic<std::size_t> next(0);
+            std::exception_ptr error;
+            std::mutex error_mutex;
+
+            auto worker = [&]() {
+                try {
+                    for (std::size_t chunk = next++; chunk < chunks; chunk = next++) {
+                        work(chunk);
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error)
+                        error = std::current_exception();
+                    next = chunks;
+                }
+            };
+
+            /* Reserved up front, so only starting a thread can throw. */
+            std::vector<std::thread> pool;
+            pool.reserve(threads - 1);
+            try {
+                for (unsigned i = 1; i < threads; ++i) {
+                    pool.push_back(std::thread(worker));
+                }
+            } catch (const std::system_error&) {
+                /* Out of threads: carry on with the ones running. */
+            }
+            worker();
+            for (std::size_t i = 0; i < pool.size(); ++i) {
+                pool[i].join();
+            }
+
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        /** OptionSyntax handler recording Match records for one argument
+         * list starting at first.
+         */
+        template <class ArgIterator>
+        struct Matcher
+        {
+            typedef index_type option_handle;
+
+            const table_type& table;
+            ArgIterator first;
+            Invocation& result;
+            std::vector<Match>& matches;
+
+            bool find(const char* name, std::size_t length, index_type& option) const
+            {
+                option = table.find(name, length);
+                return option != npos;
+            }
+
+            typename OptionType::ArgumentMode mode(index_type option) const
+            {
+                return table.mode(option);
+            }
+
+            void match(index_type option)
+            {
+                add(option, npos, 0);
+            }
+
+            void match(index_type option, ArgIterator arg, std::size_t offset)
+            {
+                add(option, static_cast<index_type>(arg - first), static_cast<index_type>(offset));
+            }
+
+            void unknown()
+            {
+                if (result.unknown < std::numeric_limits<std::uint16_t>::max())
+                    ++result.unknown;
+            }
+
+            void missing_argument(ArgIterator arg)
+            {
+                (void)arg;
+                result.error = MISSING_ARGUMENT;
+            }
+
+            void operands(ArgIterator begin, ArgIterator end)
+            {
+                result.first_operand = static_cast<index_type>(begin - first);
+                result.operand_count = static_cast<index_type>(end - begin);
+            }
+
+            void add(index_type option, index_type argument, index_type offset)
+            {
+                Match record;
+                record.option = option;
+                record.value_argument = argument;
+                record.value_offset = offset;
+                matches.push_back(record);
+            }
+        };
+    };
+
+} // namespace zoidbol
+
+#endif // ZOIDBOL_BATCHPARSER__HPP
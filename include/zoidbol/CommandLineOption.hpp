@@ -21,14 +21,20 @@
  * 3. This notice may not be removed or altered from any source distribution.
  */
 
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
 #include <cstring>
 #include <functional>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 #include <iostream>
 
 #include <zoidbol/DebugStream.hpp>
+#include <zoidbol/FixedString.hpp>
+#include <zoidbol/StaticVector.hpp>
 
 // zoidbol::FOO vs zoidbol::classname::FOO.
 // #include <zoidbol/ArgumentMode.hpp>
@@ -36,6 +42,12 @@
 namespace zoidbol
 {
     /** Template class for command line options.
+     *
+     * StringType must be constructible from a null terminated const char*
+     * and provide size(), empty(), operator[], and c_str(). ListType must
+     * provide const_iterator, begin(), end(), size(), at(), and push_back().
+     * std::string and std::vector satisfy these, as do FixedString and
+     * StaticVector.
      */
     template <class StringType, class ListType>
     class CommandLineOption
@@ -48,7 +60,14 @@ namespace zoidbol
         enum ArgumentMode {
             NO_ARGUMENT,       /**< --option or bust. */
             ARGUMENT_REQUIRED, /**< --option VALUE or bust. */
-            ARGUMENT_OPTIONAL, /**< --option and --option VALUE are okay. */
+            /** --option and --option VALUE are okay.
+             *
+             * The next argument is the value unless it is a registered
+             * option or "--", so "--option -5" passes "-5". --option=VALUE
+             * and -oVALUE always supply a value, --option= an empty one.
+             * Without a value the callback gets "true", like NO_ARGUMENT.
+             */
+            ARGUMENT_OPTIONAL,
         };
 
         /** Create a command line option.
@@ -68,6 +87,7 @@ namespace zoidbol
             , mHelp(help)
             , mMode(argMode)
             , mCallback(callback)
+            , mIndependent(false)
         {
         }
 
@@ -87,6 +107,7 @@ namespace zoidbol
             , mHelp(help)
             , mMode(argMode)
             , mCallback()
+            , mIndependent(false)
         {
         }
 
@@ -105,6 +126,7 @@ namespace zoidbol
             , mHelp(help)
             , mMode(NO_ARGUMENT)
             , mCallback()
+            , mIndependent(false)
         {
         }
 
@@ -123,6 +145,7 @@ namespace zoidbol
             , mHelp(help)
             , mMode(ARGUMENT_REQUIRED)
             , mCallback()
+            , mIndependent(false)
         {
         }
 
@@ -140,6 +163,28 @@ namespace zoidbol
             return mMode;
         }
 
+        /** @returns true if the callback may run concurrently with others.
+         */
+        bool independent() const
+        {
+            return mIndependent;
+        }
+
+        /** Mark the callback as safe to run concurrently with the callbacks
+         * of other options.
+         * 
+         * Only used when CommandLineParser::set_deferred_callbacks() is on
+         * and run_callbacks() is given a ConcurrentRunner. Calls for the
+         * same option still run one at a time, in order.
+         * 
+         * @returns *this.
+         */
+        CommandLineOption& set_independent(bool independent)
+        {
+            mIndependent = independent;
+            return *this;
+        }
+
         /** @returns the help() message.
          */
         const string_type& help() const
@@ -175,17 +220,37 @@ namespace zoidbol
         }
 
         /** @returns value as a int.
+         *
+         * @throws std::invalid_argument or std::out_of_range like std::stoi().
          */
         int to_int() const
         {
-            return std::stoi(mValue);
+            const char* str = mValue.c_str();
+            char* end = nullptr;
+            errno = 0;
+            long result = std::strtol(str, &end, 10);
+            if (end == str)
+                throw std::invalid_argument("zoidbol::CommandLineOption::to_int(): no conversion");
+            if (errno == ERANGE || result < INT_MIN || result > INT_MAX)
+                throw std::out_of_range("zoidbol::CommandLineOption::to_int(): out of range");
+            return static_cast<int>(result);
         }
 
         /** @returns value as a float.
+         *
+         * @throws std::invalid_argument or std::out_of_range like std::stof().
          */
         float to_float() const
         {
-            return std::stof(mValue);
+            const char* str = mValue.c_str();
+            char* end = nullptr;
+            errno = 0;
+            float result = std::strtof(str, &end);
+            if (end == str)
+                throw std::invalid_argument("zoidbol::CommandLineOption::to_float(): no conversion");
+            if (errno == ERANGE)
+                throw std::out_of_range("zoidbol::CommandLineOption::to_float(): out of range");
+            return result;
         }
 
         /** @returns value as a string.
@@ -195,18 +260,40 @@ namespace zoidbol
             return mValue;
         }
 
+        /** @returns reference to the current value.
+         */
+        const string_type& value() const
+        {
+            return mValue;
+        }
+
       private:
         stringlist_type mFlags;
         string_type mHelp;
         string_type mValue;
         ArgumentMode mMode;
         callback_type mCallback;
+        bool mIndependent;
     };
 
     /** Typedef using std::string and std::vector.
      */
     typedef CommandLineOption<std::string, std::vector<std::string>> StdCommandLineOption;
 
+    /** Template alias using FixedString and StaticVector.
+     *
+     * Never allocates. Exceeding StringCapacity characters in a flag, help,
+     * or value, or ListCapacity flags, throws std::length_error. The
+     * arguments given to a parser are limited by the parser, see
+     * BasicFixedCommandLineParser.
+     */
+    template <std::size_t StringCapacity, std::size_t ListCapacity>
+    using BasicFixedCommandLineOption = CommandLineOption<FixedString<StringCapacity>, StaticVector<FixedString<StringCapacity>, ListCapacity>>;
+
+    /** Typedef using FixedString<128> and room for 4 flags.
+     */
+    typedef BasicFixedCommandLineOption<128, 4> FixedCommandLineOption;
+
 } // namespace zoidbol
 
 #endif // ZOIDBOL_COMMANDLINEOPTION__HPP
@@ -21,14 +21,21 @@
  * 3. This notice may not be removed or altered from any source distribution.
  */
 
+#include <zoidbol/ArgumentView.hpp>
 #include <zoidbol/CommandLineOption.hpp>
 #include <zoidbol/CommandLineError.hpp>
 #include <zoidbol/DebugStream.hpp>
+#include <zoidbol/FlagIndex.hpp>
+#include <zoidbol/OptionSyntax.hpp>
+#include <zoidbol/StaticVector.hpp>
 
 #include <algorithm>
 #include <cstring>
+#include <exception>
 #include <iterator>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <iostream>
@@ -40,8 +47,14 @@ namespace zoidbol
      * 
      * Create the parser, add the options, and call the parse() with the
      * input arguments.
+     *
+     * OptionListType holds the option pointers passed to add_option().
+     * FlagIndexType maps every flag to its option for get() and parsing.
+     * ArgumentListType holds the arguments given to parse() and the
+     * remaining arguments(). Use StaticVector based lists, along with a
+     * FixedString based OptionType, to parse without allocating.
      */
-    template <class OptionType>
+    template <class OptionType, class OptionListType = std::vector<OptionType*>, class FlagIndexType = FlagIndex<OptionType*>, class ArgumentListType = typename OptionType::stringlist_type>
     class CommandLineParser
     {
       public:
@@ -50,28 +63,64 @@ namespace zoidbol
         typedef OptionType& option_ref;
         typedef typename option_type::string_type string_type;
         typedef typename option_type::stringlist_type stringlist_type;
-        typedef std::vector<option_ptr> option_list;
+        typedef OptionListType option_list;
+        typedef FlagIndexType flag_index;
+        typedef ArgumentListType argument_list;
+
+        /** A callback that threw during run_callbacks().
+         */
+        struct CallbackError
+        {
+            option_ptr option;
+            string_type value;
+            std::exception_ptr error;
+        };
+
+        typedef std::vector<CallbackError> callback_error_list;
 
         /** Create the parser with default configuration.
          */
         CommandLineParser()
+            : mDeferred(false)
         {
         }
 
         /** Add a command line option.
+         * 
+         * Each of the option's flags is added to the index used by get().
+         * If a flag was already added by another option, the first option
+         * keeps it.
+         * 
+         * The flags are indexed before the option is added to options(). If
+         * either fails nothing is added.
          * 
          * @param option the CommandLineOption.
+         * @throws CommandLineError when a fixed capacity option list or index
+         * is full.
          */
         CommandLineParser& add_option(const option_ptr option)
         {
-            std::back_inserter(mOptions) = option;
+            try {
+                for (typename stringlist_type::const_iterator flag = option->flags().begin(); flag != option->flags().end(); ++flag) {
+                    mIndex.insert(flag->c_str(), flag->size(), option);
+                }
+                mOptions.push_back(option);
+            } catch (const std::length_error& ex) {
+                remove_flags(option);
+                throw CommandLineError(ex.what());
+            } catch (...) {
+                remove_flags(option);
+                throw;
+            }
             return *this;
         }
 
         template <class InputIt>
         CommandLineParser& add_options(InputIt first, InputIt last)
         {
-            std::copy(first, last, std::back_inserter(mOptions));
+            for (; first != last; ++first) {
+                add_option(*first);
+            }
             return *this;
         }
 
@@ -84,7 +133,7 @@ namespace zoidbol
          * @param output passed to usage().
          * @param code passed to std::exit().
          */
-        StdCommandLineOption::callback_type default_help_callback(std::ostream& output, int code)
+        typename option_type::callback_type default_help_callback(std::ostream& output, int code)
         {
             return [this, &output, code](const string_type& unused) -> bool {
                 (void)unused;
@@ -101,7 +150,7 @@ namespace zoidbol
          */
         option_type default_help_option()
         {
-            return StdCommandLineOption({"h", "help", "?"}, "", "Display this help message.", StdCommandLineOption::NO_ARGUMENT, default_help_callback(std::cout, EXIT_SUCCESS));
+            return option_type({"h", "help", "?"}, "", "Display this help message.", option_type::NO_ARGUMENT, default_help_callback(std::cout, EXIT_SUCCESS));
         }
         #endif
 
@@ -138,13 +187,19 @@ namespace zoidbol
             if (argc == 0)
                 return;
 
-            stringlist_type args;
+            string_type name;
+            argument_list args;
 
-            for (int i = 1; i < argc; ++i) {
-                std::back_inserter(args) = argv[i];
+            try {
+                name = string_type(argv[0]);
+                for (int i = 1; i < argc; ++i) {
+                    args.push_back(string_type(argv[i]));
+                }
+            } catch (const std::length_error& ex) {
+                throw CommandLineError(ex.what());
             }
 
-            parse(argv[0], args);
+            parse(name, args);
             ZOIDBOL_DEBUG("parse(argc, argv) return");
         }
 
@@ -153,7 +208,7 @@ namespace zoidbol
          * @param name the program name, passed to set_name().
          * @param args the argument list.
          */
-        void parse(const string_type& name, const stringlist_type& args)
+        void parse(const string_type& name, const argument_list& args)
         {
             set_name(name);
             parse(args);
@@ -163,50 +218,126 @@ namespace zoidbol
         /** Parse a list of options.
          * 
          * This assumes the list is purely arguments.
+         * 
+         * A std::length_error from a fixed capacity string_type or
+         * argument_list is rethrown as a CommandLineError.
          */
-        void parse(const stringlist_type& args)
-        {
-            bool looking_for_options = true;
-
-            for (typename stringlist_type::const_iterator arg = args.begin(); arg != args.end(); ++arg) {
-                ZOIDBOL_DEBUG("args++; " << *arg << " looking_for_options: " << looking_for_options);
-
-                if (arg->empty())
-                    break;
-                if (looking_for_options) {
-                    if (arg->find("--") == 0) {
-                        /* -- means stop parsing args. */
-                        if (arg->size() == 2) {
-                            ZOIDBOL_DEBUG("found --");
-                            break;
-                        } else {
-                            ZOIDBOL_DEBUG("call parse_long_option() from arg: " << *arg);
-                            arg = parse_long_option(arg, args.end());
-                            continue;
-                        }
-                    } else if (arg[0][0] == '-') {
-                            ZOIDBOL_DEBUG("call parse_short_option() from arg: " << *arg);
-                        arg = parse_short_options(arg, args.end());
-                        continue;
-                    }
-
-                    /* Unknown / non option. */
-                    ZOIDBOL_DEBUG("parse(): start parsing at " << *arg);
-                    looking_for_options = false;
-                    ZOIDBOL_DEBUG("parse(): INNER REMAINING ARG: " << *arg);
-                    mArguments.push_back(*arg);
-                } else {
-                    // TBD: remaining args.
-                    ZOIDBOL_DEBUG("parse(): OUTER REMAINING ARG: " << *arg);
-                    mArguments.push_back(*arg);
-                }
+        void parse(const argument_list& args)
+        {
+            try {
+                parse_arguments(args.begin(), args.end());
+            } catch (const std::length_error& ex) {
+                throw CommandLineError(ex.what());
             }
             ZOIDBOL_DEBUG("parse(args) return");
         }
 
+        /** Parse a range of ArgumentView, such as from ShellTokenizer.
+         * 
+         * Like parse(args) but without copying the arguments first. Only
+         * values and remaining arguments() are copied into string_type.
+         */
+        void parse(const ArgumentView* first, const ArgumentView* last)
+        {
+            try {
+                parse_arguments(first, last);
+            } catch (const std::length_error& ex) {
+                throw CommandLineError(ex.what());
+            }
+            ZOIDBOL_DEBUG("parse(first, last) return");
+        }
+
+        /** Defer option callbacks until run_callbacks().
+         * 
+         * When on, parse() only records each matched option and its value.
+         * The callbacks, and updating the option values, happen in
+         * run_callbacks(). Recording allocates, even with fixed capacity
+         * types.
+         * 
+         * @returns *this.
+         */
+        CommandLineParser& set_deferred_callbacks(bool deferred)
+        {
+            mDeferred = deferred;
+            return *this;
+        }
+
+        /** @returns true if callbacks are deferred until run_callbacks().
+         */
+        bool deferred_callbacks() const
+        {
+            return mDeferred;
+        }
+
+        /** Run the callbacks recorded by parse() with deferred callbacks.
+         * 
+         * The callbacks run on the calling thread in argument order. To run
+         * the callbacks of independent() options concurrently pass a
+         * ConcurrentRunner, from ConcurrentRunner.hpp, to
+         * run_callbacks(runner).
+         * 
+         * Every callback runs even if others throw. Afterwards the errors
+         * are available from callback_errors() in argument order.
+         * 
+         * @throws CommandLineError listing every error, in argument order.
+         */
+        void run_callbacks()
+        {
+            run_callbacks(SerialRunner());
+        }
+
+        /** Like run_callbacks(), but runner decides where each call runs.
+         * 
+         * runner is called once as runner(count, option_of, call), where
+         * option_of(i) returns the option of the i'th recorded call and
+         * call(i) runs it, keeping any error. runner must make each call in
+         * [0, count) exactly once, and the calls for one option in order.
+         */
+        template <class Runner>
+        void run_callbacks(Runner runner)
+        {
+            pending_list pending;
+            std::swap(pending, mPending);
+            mCallbackErrors.clear();
+
+            std::vector<std::exception_ptr> errors(pending.size());
+            runner(pending.size(), [&pending](size_t i) -> option_ptr {
+                return pending[i].first;
+            }, [&pending, &errors](size_t i) {
+                run_callback(pending[i], errors[i]);
+            });
+
+            std::string message;
+            for (size_t i = 0; i < pending.size(); ++i) {
+                if (!errors[i])
+                    continue;
+                CallbackError failed = {pending[i].first, pending[i].second, errors[i]};
+                mCallbackErrors.push_back(failed);
+
+                message += message.empty() ? "run_callbacks(): " : "; ";
+                try {
+                    std::rethrow_exception(errors[i]);
+                } catch (const std::exception& ex) {
+                    message += ex.what();
+                } catch (...) {
+                    message += "unknown exception";
+                }
+            }
+            if (!mCallbackErrors.empty())
+                throw CommandLineError(message);
+        }
+
+        /** @returns the callbacks that threw during the last
+         * run_callbacks(), in argument order.
+         */
+        const callback_error_list& callback_errors() const
+        {
+            return mCallbackErrors;
+        }
+
         /** @returns arguments remaining after parsing the options.
          */
-        const stringlist_type& arguments() const
+        const argument_list& arguments() const
         {
             return mArguments;
         }
@@ -218,6 +349,55 @@ namespace zoidbol
             return mOptions;
         }
 
+        /** Look up an option by any of its flags in constant time.
+         * 
+         * @param name the flag without any '-' prefix, e.g. "threads".
+         * @returns the pointer given to add_option(), or nullptr if no
+         * option has that flag. It stays valid as long as the option does,
+         * so it may be cached.
+         */
+        option_ptr get(const char* name) const
+        {
+            return find_option(name, std::strlen(name));
+        }
+
+        option_ptr get(const string_type& name) const
+        {
+            return find_option(name.c_str(), name.size());
+        }
+
+        /** @returns get(name)->to_string().
+         * @throws std::out_of_range if no option has that flag.
+         */
+        string_type get_string(const char* name) const
+        {
+            return lookup(name, "get_string")->to_string();
+        }
+
+        /** @returns get(name)->to_bool().
+         * @throws std::out_of_range if no option has that flag.
+         */
+        bool get_bool(const char* name) const
+        {
+            return lookup(name, "get_bool")->to_bool();
+        }
+
+        /** @returns get(name)->to_int().
+         * @throws std::out_of_range if no option has that flag.
+         */
+        int get_int(const char* name) const
+        {
+            return lookup(name, "get_int")->to_int();
+        }
+
+        /** @returns get(name)->to_float().
+         * @throws std::out_of_range if no option has that flag.
+         */
+        float get_float(const char* name) const
+        {
+            return lookup(name, "get_float")->to_float();
+        }
+
         /** Write standard usage message.
          * 
          * @param out the output stream to write to.
@@ -247,128 +427,138 @@ namespace zoidbol
         }
 
       private:
+        typedef std::pair<option_ptr, string_type> pending_callback;
+        typedef std::vector<pending_callback> pending_list;
+
         option_list mOptions;
+        flag_index mIndex;
         string_type mProgram;
-        stringlist_type mArguments;
+        argument_list mArguments;
+        bool mDeferred;
+        pending_list mPending;
+        callback_error_list mCallbackErrors;
 
-        typename stringlist_type::const_iterator parse_short_options(typename stringlist_type::const_iterator arg, typename stringlist_type::const_iterator last)
+        /** Call opt's callback now or record it for run_callbacks().
+         */
+        void invoke(option_ptr opt, const string_type& value)
         {
-            ZOIDBOL_DEBUG("parse_short_options(): arg: " << *arg << " arg->size(): " << arg->size());
+            if (mDeferred)
+                mPending.push_back(pending_callback(opt, value));
+            else
+                opt->callback(value);
+        }
 
-            size_t bounds = arg->size();
-            const char* a = arg->c_str();
-            string_type value;
-            const char* missing_arg = "parse_short_option(): arg required but not given!";
-
-            for (size_t i = 1; i < bounds; ++i) {
-                ZOIDBOL_DEBUG("testing for " << a[i] << std::endl);
-                for (typename option_list::iterator optit = mOptions.begin(); optit != mOptions.end(); ++optit) {
-                    option_ptr opt = *optit;
-                    const stringlist_type& flags = opt->flags();
-                    bool found = false;
-                    for (typename stringlist_type::const_iterator flag = opt->flags().begin(); flag != opt->flags().end(); ++flag) {
-                        /* long flags. */
-                        if (flag->size() > 1)
-                            continue;
-
-                        ZOIDBOL_DEBUG(flag->at(0) << " == a[" << i << "]: " << a[i]);
-                        if (flag->at(0) == a[i]) {
-                            ZOIDBOL_DEBUG("MATCH: " << a[i]);
-                            switch (opt->mode()) {
-                                case option_type::NO_ARGUMENT:
-                                    opt->callback("true");
-                                    break;
-                                case option_type::ARGUMENT_REQUIRED:
-                                    /* Can be like "-[opts]o arg" or "-[opts]oarg" */
-                                    if ((bounds - i) > 1) {
-                                        value = arg->substr(i + 1);
-                                        if (value.empty()) {
-                                            throw CommandLineError(missing_arg);
-                                        }
-                                        i += value.size();
-                                    } else {
-                                        arg = std::next(arg);
-                                        if (arg == last || (!arg->empty() && arg->at(0) == '-')) {
-                                            throw CommandLineError(missing_arg);
-                                        }
-                                        value = *arg;
-                                    }
-                                    opt->callback(value);
-                                    break;
-                                case option_type::ARGUMENT_OPTIONAL:
-                                    ZOIDBOL_DEBUG("XXX: TODO: optional args for short options ...");
-                                    break;
-                                default:
-                                    throw std::logic_error("zoidbol::CommandLineParser::parse_short_options(): invalid opt->mode()");
-                            }
-                            found = true;
-                            break;
-                        }
-                    }
-                    ZOIDBOL_DEBUG("++opt; found: " << found);
-                    if (found)
-                        break;
+        /** Runner making every call on the calling thread, in order.
+         */
+        struct SerialRunner
+        {
+            template <class OptionOf, class Call>
+            void operator()(size_t count, OptionOf option_of, Call call) const
+            {
+                (void)option_of;
+                for (size_t i = 0; i < count; ++i) {
+                    call(i);
                 }
             }
+        };
 
-            ZOIDBOL_DEBUG("parse_short_options() return");
-            return arg;
+        static void run_callback(const pending_callback& call, std::exception_ptr& error)
+        {
+            try {
+                call.first->callback(call.second);
+            } catch (...) {
+                error = std::current_exception();
+            }
         }
 
-        typename stringlist_type::const_iterator parse_long_option(typename stringlist_type::const_iterator arg, typename stringlist_type::const_iterator last)
+        /** OptionSyntax handler invoking the matched options.
+         */
+        struct Matcher
         {
-            ZOIDBOL_DEBUG("parse_long_option(" << *arg << ")");
-            for (typename option_list::iterator optit = mOptions.begin(); optit != mOptions.end(); ++optit) {
-                option_ptr opt = *optit;
-                const stringlist_type& flags = opt->flags();
-                for (typename stringlist_type::const_iterator flag = opt->flags().begin(); flag != opt->flags().end(); ++flag) {
-                    ZOIDBOL_DEBUG("test flag " << *flag);
-                    // short flags.
-                    if (flag->size() == 1)
-                        continue;
-
-                    const char *a = arg->c_str();
-                    a += 2; // skip --
-
-                    if (strcmp(flag->c_str(), a) == 0 || strncmp(flag->c_str(), a, std::min(arg->size(), flag->size())) == 0) {
-                        string_type value;
-
-                        if (opt->mode() == option_type::NO_ARGUMENT) {
-                            // na na na
-                            value = "true";
-                        } else {
-                            typename string_type::size_type equals = arg->find('=');
-                            if (equals != string_type::npos) {
-                                value = arg->substr(equals + 1);
-                                if (value.empty() && opt->mode() == option_type::ARGUMENT_REQUIRED)
-                                    throw CommandLineError("parse_long_option(): arg required but not given!");
-                            } else {
-                                typename stringlist_type::const_iterator next_arg = std::next(arg);
-                                if (next_arg == last) {
-                                    if (opt->mode() == option_type::ARGUMENT_REQUIRED)
-                                        throw CommandLineError("parse_long_option(): arg required but not given!");
-                                }
-                                if (opt->mode() == option_type::ARGUMENT_OPTIONAL) {
-                                    if ((*next_arg)[0] == '-') {
-                                        ZOIDBOL_DEBUG("XXX: TODO: optional args should only consue next_arg if it is not a registered option...");
-                                    }
-                                }
-                                value = *next_arg;
-                                arg = std::next(arg);
-                            }
-                            ZOIDBOL_DEBUG("value = *next_arg = " << value);
-                        }
-                        /* TBD: return value, args. */
-                        ZOIDBOL_DEBUG("opt->callback(" << value << ")");
-                        opt->callback(value);
-                        ZOIDBOL_DEBUG("opt->callback(" << value << ") -> opt->to_string(): " << opt->to_string());
-                        break;
-                    }
+            typedef option_ptr option_handle;
+
+            CommandLineParser& parser;
+
+            bool find(const char* name, size_t length, option_ptr& option) const
+            {
+                option = parser.find_option(name, length);
+                return option != nullptr;
+            }
+
+            typename option_type::ArgumentMode mode(option_ptr option) const
+            {
+                return option->mode();
+            }
+
+            void match(option_ptr option)
+            {
+                parser.invoke(option, "true");
+            }
+
+            template <class ArgIterator>
+            void match(option_ptr option, ArgIterator arg, size_t offset)
+            {
+                ZOIDBOL_DEBUG("value = " << (arg->c_str() + offset));
+                parser.invoke(option, string_type(arg->c_str() + offset, arg->size() - offset));
+            }
+
+            void unknown()
+            {
+            }
+
+            template <class ArgIterator>
+            void missing_argument(ArgIterator arg)
+            {
+                if ((*arg)[1] == '-')
+                    throw CommandLineError("parse_long_option(): arg required but not given!");
+                throw CommandLineError("parse_short_option(): arg required but not given!");
+            }
+
+            template <class ArgIterator>
+            void operands(ArgIterator first, ArgIterator last)
+            {
+                for (; first != last; ++first) {
+                    ZOIDBOL_DEBUG("parse(): REMAINING ARG: " << *first);
+                    parser.mArguments.push_back(string_type(first->c_str(), first->size()));
                 }
             }
+        };
 
-            ZOIDBOL_DEBUG("parse_long_option() return");
-            return arg;
+        /** ArgIterator's value_type needs size(), empty(), operator[], and
+         * a null terminated c_str().
+         */
+        template <class ArgIterator>
+        void parse_arguments(ArgIterator first, ArgIterator last)
+        {
+            Matcher matcher = {*this};
+            OptionSyntax<option_type>::parse(first, last, matcher);
+        }
+
+        /** Undo a failed add_option(): remove option's flags from the
+         * index, unless option was already added before.
+         */
+        void remove_flags(const option_ptr option)
+        {
+            if (std::find(mOptions.begin(), mOptions.end(), option) != mOptions.end())
+                return;
+            for (typename stringlist_type::const_iterator flag = option->flags().begin(); flag != option->flags().end(); ++flag) {
+                if (find_option(flag->c_str(), flag->size()) == option)
+                    mIndex.erase(flag->c_str(), flag->size());
+            }
+        }
+
+        option_ptr find_option(const char* name, size_t length) const
+        {
+            const option_ptr* found = mIndex.find(name, length);
+            return found != nullptr ? *found : nullptr;
+        }
+
+        option_ptr lookup(const char* name, const char* caller) const
+        {
+            option_ptr opt = find_option(name, std::strlen(name));
+            if (opt == nullptr)
+                throw std::out_of_range(std::string("zoidbol::CommandLineParser::") + caller + "(): unknown option: " + name);
+            return opt;
         }
     };
 
@@ -376,6 +566,29 @@ namespace zoidbol
      */
     typedef CommandLineParser<StdCommandLineOption> StdCommandLineParser;
 
+    /** Template alias using a FixedCommandLineOption compatible OptionType,
+     * a StaticVector of OptionCapacity options, and a StaticVector of
+     * ArgumentCapacity arguments.
+     * 
+     * The flag index has room for 8 * OptionCapacity slots, rounded up to a
+     * power of two. It is kept at most half full, so every option can have
+     * at least 4 flags.
+     * 
+     * parse(argc, argv) copies the arguments into an argument_list on the
+     * stack, so it needs ArgumentCapacity strings of stack space.
+     */
+    template <std::size_t OptionCapacity, class OptionType = FixedCommandLineOption, std::size_t ArgumentCapacity = 64>
+    using BasicFixedCommandLineParser = CommandLineParser<OptionType, StaticVector<OptionType*, OptionCapacity>, FlagIndex<OptionType*, StaticVector<FlagIndexSlot<OptionType*>, next_power_of_two(8 * OptionCapacity)>>, StaticVector<typename OptionType::string_type, ArgumentCapacity>>;
+
+    /** Typedef using FixedCommandLineOption and room for 32 options.
+     * 
+     * Parses at most 64 arguments after the program name. Each argument,
+     * and the program name, is at most 128 characters. More throws
+     * CommandLineError; use BasicFixedCommandLineParser to pick other
+     * limits.
+     */
+    typedef BasicFixedCommandLineParser<32> FixedCommandLineParser;
+
 } // namespace zoidbol
 
 #endif // ZOIDBOL_COMMANDLINEPARSER__HPP
@@ -0,0 +1,116 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+#ifndef ZOIDBOL_CONCURRENTRUNNER__HPP
+#define ZOIDBOL_CONCURRENTRUNNER__HPP
+/*-
+ * Copyright (c) 2021-current, Terry Mathew Poulin <BigBoss1964@gmail.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace zoidbol
+{
+    /** Runner for CommandLineParser::run_callbacks(runner) that runs the
+     * callbacks of independent() options concurrently.
+     *
+     * Callbacks of options that are not independent() run on the calling
+     * thread in argument order. The independent() options are shared by a
+     * pool of threads, which the calling thread joins once it is done. Each
+     * thread claims one option at a time and runs its callbacks in argument
+     * order. If a thread cannot be started the ones running share the
+     * rest.
+     */
+    class ConcurrentRunner
+    {
+      public:
+        /** Create a runner.
+         *
+         * @param threads size of the pool, 0 for hardware_concurrency().
+         */
+        explicit ConcurrentRunner(unsigned threads = 0)
+            : mThreads(threads)
+        {
+        }
+
+        template <class OptionOf, class Call>
+        void operator()(std::size_t count, OptionOf option_of, Call call) const
+        {
+            typedef decltype(option_of(0)) option_ptr;
+
+            /* Group the independent calls by option, keeping argument order
+             * within each group. groups[g] is where group g starts. */
+            std::vector<std::size_t> order;
+            for (std::size_t i = 0; i < count; ++i) {
+                if (option_of(i)->independent())
+                    order.push_back(i);
+            }
+            std::stable_sort(order.begin(), order.end(), [&option_of](std::size_t lhs, std::size_t rhs) {
+                return std::less<option_ptr>()(option_of(lhs), option_of(rhs));
+            });
+            std::vector<std::size_t> groups;
+            for (std::size_t k = 0; k < order.size(); ++k) {
+                if (k == 0 || option_of(order[k]) != option_of(order[k - 1]))
+                    groups.push_back(k);
+            }
+            std::size_t group_count = groups.size();
+            groups.push_back(order.size());
+
+            std::atomic<std::size_t> next(0);
+            auto worker = [&call, &order, &groups, &next, group_count]() {
+                for (std::size_t g = next++; g < group_count; g = next++) {
+                    for (std::size_t k = groups[g]; k < groups[g + 1]; ++k) {
+                        call(order[k]);
+                    }
+                }
+            };
+
+            unsigned threads = mThreads != 0 ? mThreads : std::max(1u, std::thread::hardware_concurrency());
+            unsigned pool_size = static_cast<unsigned>(std::min<std::size_t>(threads, group_count));
+            std::vector<std::thread> pool;
+            pool.reserve(pool_size);
+            try {
+                for (unsigned i = 0; i < pool_size; ++i) {
+                    pool.push_back(std::thread(worker));
+                }
+            } catch (const std::system_error&) {
+                /* Out of threads: the calling thread picks up the rest. */
+            }
+
+            for (std::size_t i = 0; i < count; ++i) {
+                if (!option_of(i)->independent())
+                    call(i);
+            }
+            worker();
+            for (std::size_t i = 0; i < pool.size(); ++i) {
+                pool[i].join();
+            }
+        }
+
+      private:
+        unsigned mThreads;
+    };
+
+} // namespace zoidbol
+
+#endif // ZOIDBOL_CONCURRENTRUNNER__HPP
@@ -0,0 +1,237 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+#ifndef ZOIDBOL_FIXEDSTRING__HPP
+#define ZOIDBOL_FIXEDSTRING__HPP
+/*-
+ * Copyright (c) 2021-current, Terry Mathew Poulin <BigBoss1964@gmail.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+
+namespace zoidbol
+{
+    /** Fixed capacity, null terminated, string.
+     *
+     * Provides the subset of std::string used by CommandLineOption and
+     * CommandLineParser. The characters are stored inline so it never
+     * allocates. Exceeding Capacity throws std::length_error.
+     */
+    template <std::size_t Capacity>
+    class FixedString
+    {
+      public:
+        typedef char value_type;
+        typedef std::size_t size_type;
+        typedef char* iterator;
+        typedef const char* const_iterator;
+
+        static const size_type npos = static_cast<size_type>(-1);
+
+        /** Create an empty string.
+         */
+        FixedString()
+            : mSize(0)
+        {
+            mData[0] = '\0';
+        }
+
+        /** Create a string from a null terminated C string.
+         */
+        FixedString(const char* str)
+            : mSize(0)
+        {
+            assign(str, std::strlen(str));
+        }
+
+        /** Create a string from the first count characters of str.
+         */
+        FixedString(const char* str, size_type count)
+            : mSize(0)
+        {
+            assign(str, count);
+        }
+
+        FixedString& operator=(const char* str)
+        {
+            return assign(str, std::strlen(str));
+        }
+
+        /** Replace the contents with the first count characters of str.
+         *
+         * @throws std::length_error if count exceeds capacity().
+         */
+        FixedString& assign(const char* str, size_type count)
+        {
+            if (count > Capacity)
+                throw std::length_error("zoidbol::FixedString::assign(): capacity exceeded");
+            std::memmove(mData, str, count);
+            mSize = count;
+            mData[mSize] = '\0';
+            return *this;
+        }
+
+        /** Append the first count characters of str.
+         *
+         * @throws std::length_error if the result would exceed capacity().
+         */
+        FixedString& append(const char* str, size_type count)
+        {
+            if (count > Capacity - mSize)
+                throw std::length_error("zoidbol::FixedString::append(): capacity exceeded");
+            std::memmove(mData + mSize, str, count);
+            mSize += count;
+            mData[mSize] = '\0';
+            return *this;
+        }
+
+        void push_back(char ch)
+        {
+            append(&ch, 1);
+        }
+
+        void clear()
+        {
+            mSize = 0;
+            mData[0] = '\0';
+        }
+
+        size_type size() const
+        {
+            return mSize;
+        }
+
+        size_type length() const
+        {
+            return mSize;
+        }
+
+        bool empty() const
+        {
+            return mSize == 0;
+        }
+
+        static size_type capacity()
+        {
+            return Capacity;
+        }
+
+        static size_type max_size()
+        {
+            return Capacity;
+        }
+
+        const char* c_str() const
+        {
+            return mData;
+        }
+
+        const char* data() const
+        {
+            return mData;
+        }
+
+        char& operator[](size_type pos)
+        {
+            return mData[pos];
+        }
+
+        const char& operator[](size_type pos) const
+        {
+            return mData[pos];
+        }
+
+        const char& at(size_type pos) const
+        {
+            if (pos >= mSize)
+                throw std::out_of_range("zoidbol::FixedString::at(): pos out of range");
+            return mData[pos];
+        }
+
+        iterator begin()
+        {
+            return mData;
+        }
+
+        const_iterator begin() const
+        {
+            return mData;
+        }
+
+        iterator end()
+        {
+            return mData + mSize;
+        }
+
+        const_iterator end() const
+        {
+            return mData + mSize;
+        }
+
+      private:
+        size_type mSize;
+        char mData[Capacity + 1];
+    };
+
+    template <std::size_t Capacity>
+    bool operator==(const FixedString<Capacity>& lhs, const FixedString<Capacity>& rhs)
+    {
+        return lhs.size() == rhs.size() && std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+    }
+
+    template <std::size_t Capacity>
+    bool operator==(const FixedString<Capacity>& lhs, const char* rhs)
+    {
+        return std::strcmp(lhs.c_str(), rhs) == 0;
+    }
+
+    template <std::size_t Capacity>
+    bool operator==(const char* lhs, const FixedString<Capacity>& rhs)
+    {
+        return rhs == lhs;
+    }
+
+    template <std::size_t Capacity>
+    bool operator!=(const FixedString<Capacity>& lhs, const FixedString<Capacity>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <std::size_t Capacity>
+    bool operator!=(const FixedString<Capacity>& lhs, const char* rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <std::size_t Capacity>
+    bool operator!=(const char* lhs, const FixedString<Capacity>& rhs)
+    {
+        return !(rhs == lhs);
+    }
+
+    template <std::size_t Capacity>
+    std::ostream& operator<<(std::ostream& out, const FixedString<Capacity>& str)
+    {
+        return out.write(str.data(), static_cast<std::streamsize>(str.size()));
+    }
+
+} // namespace zoidbol
+
+#endif // ZOIDBOL_FIXEDSTRING__HPP
@@ -0,0 +1,247 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+#ifndef ZOIDBOL_FLAGINDEX__HPP
+#define ZOIDBOL_FLAGINDEX__HPP
+/*-
+ * Copyright (c) 2021-current, Terry Mathew Poulin <BigBoss1964@gmail.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace zoidbol
+{
+    /** @returns the smallest power of two that is at least n.
+     */
+    constexpr std::size_t next_power_of_two(std::size_t n)
+    {
+        std::size_t p = 1;
+        while (p < n) {
+            p *= 2;
+        }
+        return p;
+    }
+
+    /** One slot of a FlagIndex.
+     *
+     * A hash of zero marks an empty slot.
+     */
+    template <class T>
+    struct FlagIndexSlot
+    {
+        std::size_t hash;
+        const char* key;
+        std::size_t length;
+        T value;
+
+        FlagIndexSlot()
+            : hash(0)
+            , key(nullptr)
+            , length(0)
+            , value()
+        {
+        }
+    };
+
+    /** Hash table mapping flag names to values.
+     *
+     * Open addressing with linear probing over a power of two number of
+     * slots, kept at most half full. The keys are not copied: they must
+     * outlive the index. CommandLineParser keys it by the flags() of each
+     * option, which live as long as the option itself.
+     *
+     * SlotListType must provide size(), max_size(), resize(), and
+     * operator[]. The index never grows past max_size() rounded down to a
+     * power of two. A StaticVector makes the index allocation free, at the
+     * cost of throwing std::length_error from insert() once it cannot grow.
+     */
+    template <class T, class SlotListType = std::vector<FlagIndexSlot<T>>>
+    class FlagIndex
+    {
+      public:
+        typedef T value_type;
+        typedef FlagIndexSlot<T> slot_type;
+        typedef SlotListType slot_list;
+
+        FlagIndex()
+            : mSlots()
+            , mCount(0)
+        {
+        }
+
+        /** Map key to value.
+         *
+         * @param key the first character of the key. Not copied.
+         * @param length the number of characters in key.
+         * @param value the value to store.
+         * @returns false if key was already present, the old value is kept.
+         */
+        bool insert(const char* key, std::size_t length, const T& value)
+        {
+            while ((mCount + 1) * 2 > mSlots.size())
+                grow();
+
+            std::size_t h = hash(key, length);
+            std::size_t mask = mSlots.size() - 1;
+            for (std::size_t i = h & mask;; i = (i + 1) & mask) {
+                slot_type& slot = mSlots[i];
+                if (slot.hash == 0) {
+                    slot.hash = h;
+                    slot.key = key;
+                    slot.length = length;
+                    slot.value = value;
+                    ++mCount;
+                    return true;
+                }
+                if (matches(slot, h, key, length))
+                    return false;
+            }
+        }
+
+        /** Look up a key.
+         *
+         * @returns pointer to the stored value, or nullptr if not found.
+         */
+        const T* find(const char* key, std::size_t length) const
+        {
+            if (mCount == 0)
+                return nullptr;
+
+            std::size_t h = hash(key, length);
+            std::size_t mask = mSlots.size() - 1;
+            for (std::size_t i = h & mask;; i = (i + 1) & mask) {
+                const slot_type& slot = mSlots[i];
+                if (slot.hash == 0)
+                    return nullptr;
+                if (matches(slot, h, key, length))
+                    return &slot.value;
+            }
+        }
+
+        /** Remove a key.
+         *
+         * @returns false if key was not present.
+         */
+        bool erase(const char* key, std::size_t length)
+        {
+            if (mCount == 0)
+                return false;
+
+            std::size_t h = hash(key, length);
+            std::size_t mask = mSlots.size() - 1;
+            std::size_t hole = h & mask;
+            for (;; hole = (hole + 1) & mask) {
+                if (mSlots[hole].hash == 0)
+                    return false;
+                if (matches(mSlots[hole], h, key, length))
+                    break;
+            }
+
+            /* Move later slots of the probe run back into the hole, unless
+             * their home slot lies after the hole. */
+            for (std::size_t i = (hole + 1) & mask; mSlots[i].hash != 0; i = (i + 1) & mask) {
+                std::size_t home = mSlots[i].hash & mask;
+                bool stays = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+                if (!stays) {
+                    mSlots[hole] = mSlots[i];
+                    hole = i;
+                }
+            }
+            mSlots[hole] = slot_type();
+            --mCount;
+            return true;
+        }
+
+        bool contains(const char* key, std::size_t length) const
+        {
+            return find(key, length) != nullptr;
+        }
+
+        /** @returns the number of keys.
+         */
+        std::size_t size() const
+        {
+            return mCount;
+        }
+
+        bool empty() const
+        {
+            return mCount == 0;
+        }
+
+        /** Remove every key, keeping the slots so refilling does not grow.
+         */
+        void clear()
+        {
+            for (std::size_t i = 0; i < mSlots.size(); ++i) {
+                mSlots[i].hash = 0;
+            }
+            mCount = 0;
+        }
+
+        /** FNV-1a hash of key, never zero.
+         */
+        static std::size_t hash(const char* key, std::size_t length)
+        {
+            std::size_t h = static_cast<std::size_t>(14695981039346656037ULL);
+            for (std::size_t i = 0; i < length; ++i) {
+                h ^= static_cast<unsigned char>(key[i]);
+                h *= static_cast<std::size_t>(1099511628211ULL);
+            }
+            return h == 0 ? 1 : h;
+        }
+
+      private:
+        SlotListType mSlots;
+        std::size_t mCount;
+
+        static bool matches(const slot_type& slot, std::size_t h, const char* key, std::size_t length)
+        {
+            return slot.hash == h && slot.length == length && std::memcmp(slot.key, key, length) == 0;
+        }
+
+        void grow()
+        {
+            std::size_t limit = 1;
+            while (limit <= mSlots.max_size() / 2) {
+                limit *= 2;
+            }
+            if (mSlots.max_size() == 0 || mSlots.size() >= limit)
+                throw std::length_error("zoidbol::FlagIndex::insert(): capacity exceeded");
+            std::size_t size = mSlots.size() == 0 ? std::min<std::size_t>(16, limit) : mSlots.size() * 2;
+
+            /* Resize first: if that throws the index is left unchanged. */
+            SlotListType old;
+            old.resize(size);
+            std::swap(old, mSlots);
+            mCount = 0;
+
+            for (std::size_t i = 0; i < old.size(); ++i) {
+                if (old[i].hash != 0)
+                    insert(old[i].key, old[i].length, old[i].value);
+            }
+        }
+    };
+
+} // namespace zoidbol
+
+#endif // ZOIDBOL_FLAGINDEX__HPP
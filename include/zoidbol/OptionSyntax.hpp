@@ -0,0 +1,253 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+#ifndef ZOIDBOL_OPTIONSYNTAX__HPP
+#define ZOIDBOL_OPTIONSYNTAX__HPP
+/*-
+ * Copyright (c) 2021-current, Terry Mathew Poulin <BigBoss1964@gmail.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+namespace zoidbol
+{
+    /** Whether parsing arg would match a registered option.
+     *
+     * Shared by CommandLineParser and BatchParser, so both decide alike
+     * whether an ARGUMENT_OPTIONAL option takes the next argument.
+     *
+     * "-x..." is an option if x is a registered flag, "--name" and
+     * "--name=value" if name is. "--" also counts, it ends the options.
+     * Anything else, like "-5" or "-", is a value.
+     *
+     * @param arg needs size(), operator[], and a null terminated c_str().
+     * @param find called as find(const char* name, std::size_t length),
+     * returns true if name is a registered flag.
+     */
+    template <class ArgType, class Find>
+    bool is_option(const ArgType& arg, Find find)
+    {
+        if (arg.size() < 2 || arg[0] != '-')
+            return false;
+        const char* a = arg.c_str();
+        if (a[1] != '-')
+            return find(a + 1, 1);
+        if (arg.size() == 2)
+            return true;
+
+        const char* equals = std::strchr(a + 2, '=');
+        std::size_t length = equals != nullptr ? static_cast<std::size_t>(equals - a - 2) : arg.size() - 2;
+        return length > 1 && find(a + 2, length);
+    }
+
+    /** The command line grammar shared by CommandLineParser and BatchParser.
+     *
+     * parse() walks the arguments and reports what it finds to a Handler,
+     * which decides what a match, an unknown flag, or an error means. The
+     * rules:
+     *
+     * - An empty argument or "--" ends parsing.
+     * - The first argument not starting with '-' starts the operands,
+     *   which run to the next empty argument.
+     * - "--name" and "--name=value" are long options. "--x" is never an
+     *   option, single character flags are only short options.
+     * - "-abc" is a cluster of short options. An option taking a value
+     *   takes the rest of the cluster if any, ending the cluster.
+     * - Otherwise an ARGUMENT_REQUIRED option takes the next argument. For
+     *   a short option it must not start with '-'.
+     * - An ARGUMENT_OPTIONAL option takes the next argument unless
+     *   is_option() says it is an option.
+     *
+     * Handler must provide:
+     *
+     * - typedef option_handle, how the handler identifies an option.
+     * - bool find(const char* name, std::size_t length, option_handle& option) const
+     * - OptionType::ArgumentMode mode(option_handle option) const
+     * - void match(option_handle option) for an option without a value.
+     * - void match(option_handle option, ArgIterator arg, std::size_t offset)
+     *   for an option whose value is arg->c_str() + offset.
+     * - void unknown() for each flag find() did not find.
+     * - void missing_argument(ArgIterator arg) when the option in arg has
+     *   no value. Parsing stops afterwards, unless it throws.
+     * - void operands(ArgIterator first, ArgIterator last)
+     */
+    template <class OptionType>
+    class OptionSyntax
+    {
+      public:
+        /** Parse [first, last) reporting to handler.
+         *
+         * ArgIterator's value_type needs size(), empty(), operator[], and a
+         * null terminated c_str().
+         */
+        template <class ArgIterator, class Handler>
+        static void parse(ArgIterator first, ArgIterator last, Handler& handler)
+        {
+            for (ArgIterator arg = first; arg != last; ++arg) {
+                if (arg->empty())
+                    return;
+
+                const char* a = arg->c_str();
+                if (a[0] != '-') {
+                    /* Everything from here to an empty argument. */
+                    ArgIterator end = arg;
+                    while (end != last && !end->empty()) {
+                        ++end;
+                    }
+                    handler.operands(arg, end);
+                    return;
+                }
+                if (a[1] == '-') {
+                    /* -- means stop parsing args. */
+                    if (arg->size() == 2)
+                        return;
+                    if (!parse_long(arg, last, handler))
+                        return;
+                } else if (!parse_short(arg, last, handler)) {
+                    return;
+                }
+            }
+        }
+
+      private:
+        /** Handle "-abc", advancing arg past a consumed value.
+         *
+         * @returns false on a missing argument.
+         */
+        template <class ArgIterator, class Handler>
+        static bool parse_short(ArgIterator& arg, ArgIterator last, Handler& handler)
+        {
+            const char* a = arg->c_str();
+            std::size_t bounds = arg->size();
+            typename Handler::option_handle option;
+
+            for (std::size_t i = 1; i < bounds; ++i) {
+                if (!handler.find(a + i, 1, option)) {
+                    handler.unknown();
+                    continue;
+                }
+
+                switch (handler.mode(option)) {
+                    case OptionType::NO_ARGUMENT:
+                        handler.match(option);
+                        break;
+                    case OptionType::ARGUMENT_REQUIRED:
+                        /* Can be like "-[opts]o arg" or "-[opts]oarg" */
+                        if ((bounds - i) > 1) {
+                            handler.match(option, arg, i + 1);
+                        } else {
+                            ArgIterator next_arg = arg;
+                            ++next_arg;
+                            if (next_arg == last || (!next_arg->empty() && (*next_arg)[0] == '-')) {
+                                handler.missing_argument(arg);
+                                return false;
+                            }
+                            arg = next_arg;
+                            handler.match(option, arg, 0);
+                        }
+                        return true;
+                    case OptionType::ARGUMENT_OPTIONAL:
+                        /* Can be like "-[opts]oarg", "-[opts]o arg", or "-[opts]o" */
+                        if ((bounds - i) > 1)
+                            handler.match(option, arg, i + 1);
+                        else
+                            optional_value(option, arg, last, handler);
+                        return true;
+                    default:
+                        throw std::logic_error("zoidbol::OptionSyntax::parse_short(): invalid mode");
+                }
+            }
+            return true;
+        }
+
+        /** Handle "--name" and "--name=value", advancing arg past a
+         * consumed value.
+         *
+         * @returns false on a missing argument.
+         */
+        template <class ArgIterator, class Handler>
+        static bool parse_long(ArgIterator& arg, ArgIterator last, Handler& handler)
+        {
+            const char* a = arg->c_str() + 2;
+            const char* equals = std::strchr(a, '=');
+            std::size_t length = equals != nullptr ? static_cast<std::size_t>(equals - a) : arg->size() - 2;
+            typename Handler::option_handle option;
+
+            if (length < 2 || !handler.find(a, length, option)) {
+                handler.unknown();
+                return true;
+            }
+
+            switch (handler.mode(option)) {
+                case OptionType::NO_ARGUMENT:
+                    handler.match(option);
+                    return true;
+                case OptionType::ARGUMENT_REQUIRED:
+                    if (equals != nullptr) {
+                        if (equals[1] == '\0') {
+                            handler.missing_argument(arg);
+                            return false;
+                        }
+                        handler.match(option, arg, length + 3);
+                    } else {
+                        ArgIterator next_arg = arg;
+                        ++next_arg;
+                        if (next_arg == last) {
+                            handler.missing_argument(arg);
+                            return false;
+                        }
+                        arg = next_arg;
+                        handler.match(option, arg, 0);
+                    }
+                    return true;
+                case OptionType::ARGUMENT_OPTIONAL:
+                    if (equals != nullptr)
+                        handler.match(option, arg, length + 3);
+                    else
+                        optional_value(option, arg, last, handler);
+                    return true;
+                default:
+                    throw std::logic_error("zoidbol::OptionSyntax::parse_long(): invalid mode");
+            }
+        }
+
+        /** Give an ARGUMENT_OPTIONAL option at arg the next argument as its
+         * value, unless there is none or it is_option().
+         */
+        template <class ArgIterator, class Handler>
+        static void optional_value(typename Handler::option_handle option, ArgIterator& arg, ArgIterator last, Handler& handler)
+        {
+            ArgIterator next_arg = arg;
+            ++next_arg;
+            auto find = [&handler](const char* name, std::size_t length) {
+                typename Handler::option_handle unused;
+                return handler.find(name, length, unused);
+            };
+            if (next_arg != last && !is_option(*next_arg, find)) {
+                arg = next_arg;
+                handler.match(option, arg, 0);
+            } else {
+                handler.match(option);
+            }
+        }
+    };
+
+} // namespace zoidbol
+
+#endif // ZOIDBOL_OPTIONSYNTAX__HPP
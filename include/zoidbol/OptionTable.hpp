@@ -0,0 +1,427 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+#ifndef ZOIDBOL_OPTIONTABLE__HPP
+#define ZOIDBOL_OPTIONTABLE__HPP
+/*-
+ * Copyright (c) 2021-current, Terry Mathew Poulin <BigBoss1964@gmail.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <zoidbol/CommandLineOption.hpp>
+#include <zoidbol/FlagIndex.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace zoidbol
+{
+    /** Bytes and heap blocks used by a data structure.
+     */
+    struct MemoryUsage
+    {
+        std::size_t bytes;  /**< Total bytes, inline and on the heap. */
+        std::size_t blocks; /**< Number of separate heap blocks. */
+
+        MemoryUsage()
+            : bytes(0)
+            , blocks(0)
+        {
+        }
+
+        MemoryUsage& operator+=(const MemoryUsage& other)
+        {
+            bytes += other.bytes;
+            blocks += other.blocks;
+            return *this;
+        }
+    };
+
+    /** @returns the heap bytes and blocks used by container, not counting
+     * the container itself.
+     *
+     * Storage that lives inside the object, like a small string or a
+     * FixedString, counts as zero.
+     */
+    template <class ContainerType>
+    MemoryUsage heap_usage(const ContainerType& container)
+    {
+        MemoryUsage usage;
+        const char* data = reinterpret_cast<const char*>(container.data());
+        const char* self = reinterpret_cast<const char*>(&container);
+        if (data != nullptr && (data < self || data >= self + sizeof(container)) && container.capacity() > 0) {
+            usage.bytes = container.capacity() * sizeof(*container.data());
+            usage.blocks = 1;
+        }
+        return usage;
+    }
+
+    /** @returns the memory used by a CommandLineOption.
+     *
+     * Counts the option itself and the heap storage of its flags, help,
+     * and value. Any state captured by the callback is not visible and not
+     * counted.
+     */
+    template <class OptionType>
+    MemoryUsage memory_usage(const OptionType& option)
+    {
+        typedef typename OptionType::stringlist_type stringlist_type;
+
+        MemoryUsage usage;
+        usage.bytes = sizeof(option);
+        usage += heap_usage(option.flags());
+        for (typename stringlist_type::const_iterator flag = option.flags().begin(); flag != option.flags().end(); ++flag) {
+            usage += heap_usage(*flag);
+        }
+        usage += heap_usage(option.help());
+        usage += heap_usage(option.value());
+        return usage;
+    }
+
+    /** Compact, read only, copy of a set of command line options.
+     *
+     * Every flag, help message, and default value is interned once into a
+     * single contiguous null terminated string pool. Each option becomes a
+     * small fixed size Record of offsets into the pool. Flags are indexed by
+     * a hash table of 8 byte slots holding a hash and an option index, so
+     * nothing in the table is a pointer and the pool can grow freely.
+     * Callbacks and parsed values are not copied.
+     *
+     * Options are identified by their index_type position in the table.
+     */
+    template <class OptionType>
+    class OptionTable
+    {
+      public:
+        typedef OptionType option_type;
+        typedef typename option_type::ArgumentMode ArgumentMode;
+        typedef typename option_type::string_type string_type;
+        typedef typename option_type::stringlist_type stringlist_type;
+        typedef std::uint32_t index_type;
+
+        static const index_type npos = static_cast<index_type>(-1);
+
+        /** One option: offsets into the pool and the flag list.
+         */
+        struct Record
+        {
+            index_type first_flag; /**< Index of the first Flag. */
+            std::uint16_t flag_count;
+            std::uint8_t mode; /**< ArgumentMode. */
+            std::uint8_t reserved;
+            index_type help;  /**< Pool offset of the help message. */
+            index_type value; /**< Pool offset of the default value. */
+        };
+
+        /** One flag: pool offset and length.
+         */
+        struct Flag
+        {
+            index_type offset;
+            index_type length;
+        };
+
+        /** One hash table slot. An entry of npos marks an empty slot.
+         */
+        struct Slot
+        {
+            std::uint32_t hash;
+            index_type entry;
+        };
+
+        OptionTable()
+            : mPool()
+            , mRecords()
+            , mFlags()
+            , mIndex()
+            , mIndexCount(0)
+            , mStrings()
+            , mStringCount(0)
+        {
+        }
+
+        /** Add a copy of option.
+         *
+         * If a flag was already added by another option, the first option
+         * keeps it.
+         *
+         * @returns the index of the new option.
+         * @throws std::length_error if the table outgrows index_type.
+         */
+        index_type add(const option_type& option)
+        {
+            const stringlist_type& flags = option.flags();
+            if (flags.size() > std::numeric_limits<std::uint16_t>::max())
+                throw std::length_error("zoidbol::OptionTable::add(): too many flags");
+            check_size(mRecords.size() + 1);
+            check_size(mFlags.size() + flags.size());
+
+            Record record;
+            record.first_flag = static_cast<index_type>(mFlags.size());
+            record.flag_count = 0;
+            record.mode = static_cast<std::uint8_t>(option.mode());
+            record.reserved = 0;
+            record.help = intern(option.help().c_str(), option.help().size());
+            record.value = intern(option.value().c_str(), option.value().size());
+
+            index_type id = static_cast<index_type>(mRecords.size());
+            mRecords.push_back(record);
+
+            for (typename stringlist_type::const_iterator flag = flags.begin(); flag != flags.end(); ++flag) {
+                Flag entry;
+                entry.offset = intern(flag->c_str(), flag->size());
+                entry.length = static_cast<index_type>(flag->size());
+                mFlags.push_back(entry);
+                ++mRecords.back().flag_count;
+
+                if (find(flag->c_str(), flag->size()) == npos)
+                    insert(mIndex, hash(flag->c_str(), flag->size()), id, ++mIndexCount);
+            }
+            return id;
+        }
+
+        /** Add a copy of each option pointed to by [first, last).
+         *
+         * Suitable for CommandLineParser::options().
+         */
+        template <class InputIt>
+        OptionTable& add(InputIt first, InputIt last)
+        {
+            for (; first != last; ++first) {
+                add(**first);
+            }
+            return *this;
+        }
+
+        /** @returns the number of options.
+         */
+        std::size_t size() const
+        {
+            return mRecords.size();
+        }
+
+        bool empty() const
+        {
+            return mRecords.empty();
+        }
+
+        /** Look up an option by any of its flags in constant time.
+         *
+         * @returns the option's index, or npos.
+         */
+        index_type find(const char* name, std::size_t length) const
+        {
+            if (mIndex.empty())
+                return npos;
+
+            std::uint32_t h = hash(name, length);
+            std::size_t mask = mIndex.size() - 1;
+            for (std::size_t i = h & mask;; i = (i + 1) & mask) {
+                const Slot& slot = mIndex[i];
+                if (slot.entry == npos)
+                    return npos;
+                if (slot.hash == h && has_flag(slot.entry, name, length))
+                    return slot.entry;
+            }
+        }
+
+        index_type find(const char* name) const
+        {
+            return find(name, std::strlen(name));
+        }
+
+        ArgumentMode mode(index_type option) const
+        {
+            return static_cast<ArgumentMode>(mRecords[option].mode);
+        }
+
+        const char* help(index_type option) const
+        {
+            return mPool.data() + mRecords[option].help;
+        }
+
+        /** @returns the default value of option.
+         */
+        const char* value(index_type option) const
+        {
+            return mPool.data() + mRecords[option].value;
+        }
+
+        std::size_t flag_count(index_type option) const
+        {
+            return mRecords[option].flag_count;
+        }
+
+        /** @returns the i'th flag of option, null terminated.
+         */
+        const char* flag(index_type option, std::size_t i) const
+        {
+            return mPool.data() + mFlags[mRecords[option].first_flag + i].offset;
+        }
+
+        std::size_t flag_length(index_type option, std::size_t i) const
+        {
+            return mFlags[mRecords[option].first_flag + i].length;
+        }
+
+        /** @returns bytes in the string pool.
+         */
+        std::size_t pool_size() const
+        {
+            return mPool.size();
+        }
+
+        /** Release memory only needed while adding options.
+         *
+         * Drops the interning index and trims spare capacity. Adding more
+         * options afterwards works, the interning index is rebuilt.
+         */
+        void shrink_to_fit()
+        {
+            std::vector<Slot>().swap(mStrings);
+            mStringCount = 0;
+            mPool.shrink_to_fit();
+            mRecords.shrink_to_fit();
+            mFlags.shrink_to_fit();
+        }
+
+        /** @returns the memory used by the table.
+         */
+        MemoryUsage memory_usage() const
+        {
+            MemoryUsage usage;
+            usage.bytes = sizeof(*this);
+            usage += heap_usage(mPool);
+            usage += heap_usage(mRecords);
+            usage += heap_usage(mFlags);
+            usage += heap_usage(mIndex);
+            usage += heap_usage(mStrings);
+            return usage;
+        }
+
+      private:
+        std::vector<char> mPool;
+        std::vector<Record> mRecords;
+        std::vector<Flag> mFlags;
+        /** Flag name to option index. */
+        std::vector<Slot> mIndex;
+        std::size_t mIndexCount;
+        /** Pool string to pool offset, used for interning. */
+        std::vector<Slot> mStrings;
+        std::size_t mStringCount;
+
+        static std::uint32_t hash(const char* key, std::size_t length)
+        {
+            return static_cast<std::uint32_t>(FlagIndex<index_type>::hash(key, length));
+        }
+
+        static void check_size(std::size_t size)
+        {
+            if (size >= npos)
+                throw std::length_error("zoidbol::OptionTable: table too large");
+        }
+
+        bool has_flag(index_type option, const char* name, std::size_t length) const
+        {
+            const Record& record = mRecords[option];
+            for (std::size_t i = 0; i < record.flag_count; ++i) {
+                const Flag& entry = mFlags[record.first_flag + i];
+                if (entry.length == length && std::memcmp(mPool.data() + entry.offset, name, length) == 0)
+                    return true;
+            }
+            return false;
+        }
+
+        /** Insert entry into slots, which will hold count entries, growing
+         * it to stay at most half full.
+         */
+        static void insert(std::vector<Slot>& slots, std::uint32_t h, index_type entry, std::size_t count)
+        {
+            if (count * 2 > slots.size()) {
+                std::size_t size = slots.empty() ? 16 : slots.size() * 2;
+                while (count * 2 > size)
+                    size *= 2;
+                Slot empty = {0, npos};
+                std::vector<Slot> old(size, empty);
+                old.swap(slots);
+                for (std::size_t i = 0; i < old.size(); ++i) {
+                    if (old[i].entry != npos)
+                        place(slots, old[i]);
+                }
+            }
+            Slot slot = {h, entry};
+            place(slots, slot);
+        }
+
+        static void place(std::vector<Slot>& slots, const Slot& slot)
+        {
+            std::size_t mask = slots.size() - 1;
+            std::size_t i = slot.hash & mask;
+            while (slots[i].entry != npos)
+                i = (i + 1) & mask;
+            slots[i] = slot;
+        }
+
+        /** @returns pool offset of a null terminated copy of str.
+         */
+        index_type intern(const char* str, std::size_t length)
+        {
+            if (mStrings.empty() && !mPool.empty())
+                reintern();
+
+            std::uint32_t h = hash(str, length);
+            if (!mStrings.empty()) {
+                std::size_t mask = mStrings.size() - 1;
+                for (std::size_t i = h & mask; mStrings[i].entry != npos; i = (i + 1) & mask) {
+                    /* Hashes collide: a shorter pooled string may end the
+                     * pool, so check length + 1 bytes fit before comparing. */
+                    std::size_t offset = mStrings[i].entry;
+                    if (mStrings[i].hash != h || offset + length >= mPool.size())
+                        continue;
+                    const char* pooled = mPool.data() + offset;
+                    if (std::memcmp(pooled, str, length) == 0 && pooled[length] == '\0')
+                        return mStrings[i].entry;
+                }
+            }
+
+            check_size(mPool.size() + length + 1);
+            index_type offset = static_cast<index_type>(mPool.size());
+            mPool.insert(mPool.end(), str, str + length);
+            mPool.push_back('\0');
+            insert(mStrings, h, offset, ++mStringCount);
+            return offset;
+        }
+
+        /** Rebuild the interning index from the pool.
+         */
+        void reintern()
+        {
+            const char* data = mPool.data();
+            for (std::size_t offset = 0; offset < mPool.size();) {
+                std::size_t length = std::strlen(data + offset);
+                insert(mStrings, hash(data + offset, length), static_cast<index_type>(offset), ++mStringCount);
+                offset += length + 1;
+            }
+        }
+    };
+
+} // namespace zoidbol
+
+#endif // ZOIDBOL_OPTIONTABLE__HPP
@@ -0,0 +1,199 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+#ifndef ZOIDBOL_SHELLTOKENIZER__HPP
+#define ZOIDBOL_SHELLTOKENIZER__HPP
+/*-
+ * Copyright (c) 2021-current, Terry Mathew Poulin <BigBoss1964@gmail.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <zoidbol/ArgumentView.hpp>
+#include <zoidbol/CommandLineError.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace zoidbol
+{
+    /** Split a command line string into arguments like a POSIX shell.
+     *
+     * Words are separated by unquoted spaces, tabs, and newlines.
+     *
+     * - A backslash outside of quotes preserves the next character.
+     * - Single quotes preserve everything up to the next single quote.
+     * - Double quotes preserve everything up to the next unescaped double
+     *   quote. Inside them a backslash only escapes $, `, ", \, and newline.
+     * - Backslash newline outside of single quotes is removed.
+     * - A # at the start of a word starts a comment up to the next newline.
+     *
+     * No expansions ($var, globs, etc.) or operators (|, ;, etc.) are done.
+     *
+     * The unescaped arguments are written back into the buffer, each null
+     * terminated, and arguments() are views into it. Nothing is allocated
+     * per argument; reusing the tokenizer reuses the ViewListType capacity.
+     */
+    template <class ViewListType = std::vector<ArgumentView>>
+    class ShellTokenizer
+    {
+      public:
+        typedef ViewListType view_list;
+
+        ShellTokenizer()
+            : mArguments()
+        {
+        }
+
+        /** Split a null terminated buffer in place.
+         *
+         * Replaces the previous arguments(). The buffer must outlive them.
+         *
+         * @returns the number of arguments.
+         * @throws CommandLineError for an unterminated quote or a trailing
+         * backslash.
+         */
+        std::size_t tokenize(char* buffer)
+        {
+            mArguments.clear();
+
+            const char* in = buffer;
+            char* out = buffer;
+
+            for (;;) {
+                /* Skip blanks, line continuations, and comments. */
+                if (is_blank(*in)) {
+                    ++in;
+                    continue;
+                }
+                if (in[0] == '\\' && in[1] == '\n') {
+                    in += 2;
+                    continue;
+                }
+                if (*in == '#') {
+                    while (*in != '\0' && *in != '\n') {
+                        ++in;
+                    }
+                    continue;
+                }
+                if (*in == '\0')
+                    break;
+
+                char* start = out;
+                while (*in != '\0' && !is_blank(*in)) {
+                    switch (*in) {
+                        case '\\':
+                            if (in[1] == '\0')
+                                throw CommandLineError("ShellTokenizer::tokenize(): trailing backslash");
+                            if (in[1] != '\n')
+                                *out++ = in[1];
+                            in += 2;
+                            break;
+                        case '\'':
+                            for (++in; *in != '\''; ++in) {
+                                if (*in == '\0')
+                                    throw CommandLineError("ShellTokenizer::tokenize(): unterminated single quote");
+                                *out++ = *in;
+                            }
+                            ++in;
+                            break;
+                        case '"':
+                            for (++in; *in != '"'; ++in) {
+                                if (*in == '\0')
+                                    throw CommandLineError("ShellTokenizer::tokenize(): unterminated double quote");
+                                if (*in == '\\' && in[1] != '\0' && std::strchr("$`\"\\\n", in[1]) != nullptr) {
+                                    ++in;
+                                    if (*in == '\n')
+                                        continue;
+                                }
+                                *out++ = *in;
+                            }
+                            ++in;
+                            break;
+                        default:
+                            *out++ = *in++;
+                            break;
+                    }
+                }
+
+                /* The unescaped word is never longer than the input, so out
+                 * is at or before the blank or null that ended it. */
+                bool done = *in == '\0';
+                *out = '\0';
+                mArguments.push_back(ArgumentView(start, static_cast<std::size_t>(out - start)));
+                ++out;
+                if (done)
+                    break;
+                ++in;
+            }
+
+            return mArguments.size();
+        }
+
+        /** Copy input into scratch, then tokenize() that.
+         *
+         * The input is left untouched. scratch must provide resize() and
+         * operator[], e.g. std::vector<char>, and must not change while
+         * arguments() are used.
+         *
+         * @returns the number of arguments.
+         */
+        template <class ScratchType>
+        std::size_t tokenize(const char* input, std::size_t length, ScratchType& scratch)
+        {
+            scratch.resize(length + 1);
+            char* buffer = &scratch[0];
+            std::memcpy(buffer, input, length);
+            buffer[length] = '\0';
+            return tokenize(buffer);
+        }
+
+        /** @returns views of the arguments from the last tokenize().
+         */
+        const view_list& arguments() const
+        {
+            return mArguments;
+        }
+
+        std::size_t size() const
+        {
+            return mArguments.size();
+        }
+
+        /** Pass arguments() to parser.parse(first, last).
+         *
+         * Like CommandLineParser::parse(args) every argument is parsed,
+         * there is no program name.
+         */
+        template <class ParserType>
+        void parse(ParserType& parser) const
+        {
+            const ArgumentView* first = mArguments.empty() ? nullptr : &mArguments[0];
+            parser.parse(first, first + mArguments.size());
+        }
+
+      private:
+        view_list mArguments;
+
+        static bool is_blank(char ch)
+        {
+            return ch == ' ' || ch == '\t' || ch == '\n';
+        }
+    };
+
+} // namespace zoidbol
+
+#endif // ZOIDBOL_SHELLTOKENIZER__HPP
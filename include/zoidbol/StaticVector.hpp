@@ -0,0 +1,212 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+#ifndef ZOIDBOL_STATICVECTOR__HPP
+#define ZOIDBOL_STATICVECTOR__HPP
+/*-
+ * Copyright (c) 2021-current, Terry Mathew Poulin <BigBoss1964@gmail.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+
+namespace zoidbol
+{
+    /** Fixed capacity vector.
+     *
+     * Provides the subset of std::vector used by CommandLineOption and
+     * CommandLineParser. The elements are stored inline so it never
+     * allocates. Exceeding Capacity throws std::length_error.
+     *
+     * T must be default constructible: all Capacity elements always exist,
+     * only the first size() are in use.
+     */
+    template <class T, std::size_t Capacity>
+    class StaticVector
+    {
+        static_assert(Capacity > 0, "zoidbol::StaticVector requires a non-zero Capacity");
+
+      public:
+        typedef T value_type;
+        typedef std::size_t size_type;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef T* iterator;
+        typedef const T* const_iterator;
+
+        /** Create an empty vector.
+         */
+        StaticVector()
+            : mItems()
+            , mSize(0)
+        {
+        }
+
+        /** Create a vector holding a copy of each element of init.
+         *
+         * @throws std::length_error if init is larger than capacity().
+         */
+        StaticVector(std::initializer_list<T> init)
+            : mItems()
+            , mSize(0)
+        {
+            for (typename std::initializer_list<T>::const_iterator it = init.begin(); it != init.end(); ++it) {
+                push_back(*it);
+            }
+        }
+
+        /** Append a copy of value.
+         *
+         * @throws std::length_error if the vector is full.
+         */
+        void push_back(const T& value)
+        {
+            if (mSize == Capacity)
+                throw std::length_error("zoidbol::StaticVector::push_back(): capacity exceeded");
+            mItems[mSize++] = value;
+        }
+
+        void pop_back()
+        {
+            mItems[--mSize] = T();
+        }
+
+        /** Change size() to count, default constructing new elements.
+         *
+         * @throws std::length_error if count exceeds capacity().
+         */
+        void resize(size_type count)
+        {
+            if (count > Capacity)
+                throw std::length_error("zoidbol::StaticVector::resize(): capacity exceeded");
+            for (size_type i = count; i < mSize; ++i) {
+                mItems[i] = T();
+            }
+            for (size_type i = mSize; i < count; ++i) {
+                mItems[i] = T();
+            }
+            mSize = count;
+        }
+
+        void clear()
+        {
+            resize(0);
+        }
+
+        size_type size() const
+        {
+            return mSize;
+        }
+
+        bool empty() const
+        {
+            return mSize == 0;
+        }
+
+        static size_type capacity()
+        {
+            return Capacity;
+        }
+
+        static size_type max_size()
+        {
+            return Capacity;
+        }
+
+        T* data()
+        {
+            return mItems;
+        }
+
+        const T* data() const
+        {
+            return mItems;
+        }
+
+        reference operator[](size_type pos)
+        {
+            return mItems[pos];
+        }
+
+        const_reference operator[](size_type pos) const
+        {
+            return mItems[pos];
+        }
+
+        reference at(size_type pos)
+        {
+            if (pos >= mSize)
+                throw std::out_of_range("zoidbol::StaticVector::at(): pos out of range");
+            return mItems[pos];
+        }
+
+        const_reference at(size_type pos) const
+        {
+            if (pos >= mSize)
+                throw std::out_of_range("zoidbol::StaticVector::at(): pos out of range");
+            return mItems[pos];
+        }
+
+        reference front()
+        {
+            return mItems[0];
+        }
+
+        const_reference front() const
+        {
+            return mItems[0];
+        }
+
+        reference back()
+        {
+            return mItems[mSize - 1];
+        }
+
+        const_reference back() const
+        {
+            return mItems[mSize - 1];
+        }
+
+        iterator begin()
+        {
+            return mItems;
+        }
+
+        const_iterator begin() const
+        {
+            return mItems;
+        }
+
+        iterator end()
+        {
+            return mItems + mSize;
+        }
+
+        const_iterator end() const
+        {
+            return mItems + mSize;
+        }
+
+      private:
+        T mItems[Capacity];
+        size_type mSize;
+    };
+
+} // namespace zoidbol
+
+#endif // ZOIDBOL_STATICVECTOR__HPP
@@ -0,0 +1,105 @@
+/* vim: set filetype=c tabstop=4 shiftwidth=4 expandtab : */
+#ifndef ZOIDBOL_GETOPT__H
+#define ZOIDBOL_GETOPT__H
+/*-
+ * Copyright (c) 2021-current, Terry Mathew Poulin <BigBoss1964@gmail.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/*
+ * C interface compatible with GNU getopt_long(), provided by the
+ * zoidbol_getopt library.
+ *
+ * Behaves like glibc: argv is permuted so non options end up last unless
+ * optstring starts with '+' or POSIXLY_CORRECT is set, a leading '-'
+ * returns non options as 1, a leading ':' returns ':' for a missing
+ * argument, and long options may be abbreviated to any unambiguous prefix.
+ * The "W;" extension is not supported.
+ *
+ * Long options are found through a hash index instead of a linear scan.
+ * The index is built when a scan starts (the first call, or optind set to
+ * 0) and when longopts changes address, so a table must not be changed in
+ * place in the middle of a scan.
+ *
+ * Like getopt_long() this keeps global state and is not thread safe.
+ *
+ * Define ZOIDBOL_GETOPT_COMPAT, and include this after <getopt.h>, to
+ * map getopt(), getopt_long(), optarg, optind, opterr, and optopt onto the
+ * zoidbol_ versions.
+ */
+
+#if defined(_WIN32) && !defined(ZOIDBOL_GETOPT_STATIC)
+#if defined(ZOIDBOL_GETOPT_BUILD)
+#define ZOIDBOL_GETOPT_API __declspec(dllexport)
+#else
+#define ZOIDBOL_GETOPT_API __declspec(dllimport)
+#endif
+#else
+#define ZOIDBOL_GETOPT_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Values for zoidbol_option.has_arg. */
+#define zoidbol_no_argument 0
+#define zoidbol_required_argument 1
+#define zoidbol_optional_argument 2
+
+/* Same layout as struct option from <getopt.h>. */
+struct zoidbol_option
+{
+    const char* name;
+    int has_arg;
+    int* flag;
+    int val;
+};
+
+/* Argument of the last option, or NULL. */
+extern ZOIDBOL_GETOPT_API char* zoidbol_optarg;
+
+/* Index of the next argv element. Set to 0 to start over. */
+extern ZOIDBOL_GETOPT_API int zoidbol_optind;
+
+/* Set to 0 to disable error messages on stderr. */
+extern ZOIDBOL_GETOPT_API int zoidbol_opterr;
+
+/* The option character, or long option val, that caused the last error. */
+extern ZOIDBOL_GETOPT_API int zoidbol_optopt;
+
+/* Like getopt_long(): returns the next option, or -1 when done. */
+ZOIDBOL_GETOPT_API int zoidbol_getopt_long(int argc, char* const argv[], const char* optstring, const struct zoidbol_option* longopts, int* longindex);
+
+/* Like getopt(): zoidbol_getopt_long() without long options. */
+ZOIDBOL_GETOPT_API int zoidbol_getopt(int argc, char* const argv[], const char* optstring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#if defined(ZOIDBOL_GETOPT_COMPAT)
+#define getopt(argc, argv, optstring) zoidbol_getopt((argc), (argv), (optstring))
+#define getopt_long(argc, argv, optstring, longopts, longindex) zoidbol_getopt_long((argc), (argv), (optstring), (const struct zoidbol_option*)(longopts), (longindex))
+#define optarg zoidbol_optarg
+#define optind zoidbol_optind
+#define opterr zoidbol_opterr
+#define optopt zoidbol_optopt
+#endif
+
+#endif /* ZOIDBOL_GETOPT__H */
@@ -0,0 +1,414 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+/*-
+ * Copyright (c) 2021-current, Terry Mathew Poulin <BigBoss1964@gmail.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <zoidbol/FlagIndex.hpp>
+#include <zoidbol/getopt.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <getopt.h>
+#include <cstddef>
+
+static_assert(sizeof(struct zoidbol_option) == sizeof(struct option), "zoidbol_option must match struct option");
+static_assert(offsetof(struct zoidbol_option, name) == offsetof(struct option, name), "zoidbol_option must match struct option");
+static_assert(offsetof(struct zoidbol_option, has_arg) == offsetof(struct option, has_arg), "zoidbol_option must match struct option");
+static_assert(offsetof(struct zoidbol_option, flag) == offsetof(struct option, flag), "zoidbol_option must match struct option");
+static_assert(offsetof(struct zoidbol_option, val) == offsetof(struct option, val), "zoidbol_option must match struct option");
+#endif
+
+char* zoidbol_optarg = nullptr;
+int zoidbol_optind = 1;
+int zoidbol_opterr = 1;
+int zoidbol_optopt = '?';
+
+namespace
+{
+    enum Ordering
+    {
+        PERMUTE,
+        REQUIRE_ORDER,
+        RETURN_IN_ORDER
+    };
+
+    /* How a short option character was declared in optstring. */
+    enum ShortMode
+    {
+        SHORT_NONE,
+        SHORT_NO_ARGUMENT,
+        SHORT_REQUIRED,
+        SHORT_OPTIONAL
+    };
+
+    /** Index of a longopts table.
+     *
+     * Exact names are found through a FlagIndex. Abbreviations are found by
+     * binary search of the names in sorted order, every name sharing a
+     * prefix is in one run. The sorted order is only built once an
+     * abbreviation is looked up.
+     */
+    class LongIndex
+    {
+      public:
+        LongIndex()
+            : mTable(nullptr)
+            , mExact()
+            , mSorted()
+            , mSortedValid(false)
+        {
+        }
+
+        const zoidbol_option* table() const
+        {
+            return mTable;
+        }
+
+        void build(const zoidbol_option* longopts)
+        {
+            mTable = longopts;
+            mExact.clear();
+            mSorted.clear();
+            mSortedValid = false;
+            if (longopts == nullptr)
+                return;
+
+            for (int i = 0; longopts[i].name != nullptr; ++i) {
+                mExact.insert(longopts[i].name, std::strlen(longopts[i].name), i);
+            }
+        }
+
+        /** @returns the index of the option named exactly name, or -1.
+         */
+        int exact(const char* name, std::size_t length) const
+        {
+            const int* found = mExact.find(name, length);
+            return found == nullptr ? -1 : *found;
+        }
+
+        /** Find the options whose name starts with prefix.
+         *
+         * @returns [first, last) into the sorted indexes.
+         */
+        std::pair<const int*, const int*> prefixed(const char* prefix, std::size_t length)
+        {
+            if (!mSortedValid)
+                sort();
+
+            const int* first = mSorted.data();
+            const int* last = first + mSorted.size();
+            const zoidbol_option* table = mTable;
+
+            first = std::lower_bound(first, last, prefix, [table, length](int i, const char* key) {
+                return std::strncmp(table[i].name, key, length) < 0;
+            });
+            last = std::upper_bound(first, last, prefix, [table, length](const char* key, int i) {
+                return std::strncmp(key, table[i].name, length) < 0;
+            });
+            return std::make_pair(first, last);
+        }
+
+      private:
+        const zoidbol_option* mTable;
+        zoidbol::FlagIndex<int> mExact;
+        std::vector<int> mSorted;
+        bool mSortedValid;
+
+        void sort()
+        {
+            const zoidbol_option* table = mTable;
+            for (int i = 0; table[i].name != nullptr; ++i) {
+                mSorted.push_back(i);
+            }
+            std::stable_sort(mSorted.begin(), mSorted.end(), [table](int lhs, int rhs) {
+                return std::strcmp(table[lhs].name, table[rhs].name) < 0;
+            });
+            mSortedValid = true;
+        }
+    };
+
+    /** Everything getopt_long() keeps between calls.
+     */
+    struct State
+    {
+        bool initialized;
+        Ordering ordering;
+        /* The rest of the current short option cluster, or nullptr. */
+        char* nextchar;
+        /* [first_nonopt, last_nonopt) are skipped non options still to be
+         * moved after the options. */
+        int first_nonopt;
+        int last_nonopt;
+        const char* optstring;
+        unsigned char modes[256];
+        LongIndex longopts;
+    };
+
+    State state = {false, PERMUTE, nullptr, 0, 0, nullptr, {}, LongIndex()};
+
+    void build_modes(const char* optstring)
+    {
+        std::memset(state.modes, SHORT_NONE, sizeof(state.modes));
+        state.optstring = optstring;
+
+        for (const char* p = optstring; *p != '\0'; ++p) {
+            unsigned char ch = static_cast<unsigned char>(*p);
+            ShortMode mode = SHORT_NO_ARGUMENT;
+            if (p[1] == ':') {
+                mode = p[2] == ':' ? SHORT_OPTIONAL : SHORT_REQUIRED;
+            }
+            /* Like strchr(), the first occurrence decides. ':' and ';' are
+             * never options. */
+            if (ch != ':' && ch != ';' && state.modes[ch] == SHORT_NONE)
+                state.modes[ch] = static_cast<unsigned char>(mode);
+        }
+    }
+
+    bool is_nonoption(const char* arg)
+    {
+        return arg[0] != '-' || arg[1] == '\0';
+    }
+
+    /* Move the skipped non options [first_nonopt, last_nonopt) after the
+     * options [last_nonopt, optind). */
+    void exchange(char** argv)
+    {
+        std::rotate(argv + state.first_nonopt, argv + state.last_nonopt, argv + zoidbol_optind);
+        state.first_nonopt += zoidbol_optind - state.last_nonopt;
+        state.last_nonopt = zoidbol_optind;
+    }
+
+    int missing_argument(const char* optstring)
+    {
+        return optstring[0] == ':' ? ':' : '?';
+    }
+
+    int long_option(int argc, char** argv, const char* optstring, const zoidbol_option* longopts, int* longindex, bool print_errors)
+    {
+        const char* name = state.nextchar;
+        std::size_t length = std::strcspn(name, "=");
+        state.nextchar = nullptr;
+        ++zoidbol_optind;
+
+        int found = state.longopts.exact(name, length);
+        if (found < 0) {
+            std::pair<const int*, const int*> range = state.longopts.prefixed(name, length);
+
+            /* The first match in table order wins unless another match
+             * behaves differently. */
+            for (const int* p = range.first; p != range.second; ++p) {
+                if (found < 0 || *p < found)
+                    found = *p;
+            }
+
+            std::vector<int> ambiguous;
+            for (const int* p = range.first; p != range.second; ++p) {
+                const zoidbol_option& o = longopts[*p];
+                const zoidbol_option& f = longopts[found];
+                if (o.has_arg != f.has_arg || o.flag != f.flag || o.val != f.val)
+                    ambiguous.push_back(*p);
+            }
+            if (!ambiguous.empty()) {
+                if (print_errors) {
+                    ambiguous.push_back(found);
+                    std::sort(ambiguous.begin(), ambiguous.end());
+                    std::fprintf(stderr, "%s: option '--%s' is ambiguous; possibilities:", argv[0], name);
+                    for (int i : ambiguous) {
+                        std::fprintf(stderr, " '--%s'", longopts[i].name);
+                    }
+                    std::fprintf(stderr, "\n");
+                }
+                zoidbol_optopt = 0;
+                return '?';
+            }
+        }
+
+        if (found < 0) {
+            if (print_errors)
+                std::fprintf(stderr, "%s: unrecognized option '--%s'\n", argv[0], name);
+            zoidbol_optopt = 0;
+            return '?';
+        }
+
+        const zoidbol_option& option = longopts[found];
+        if (name[length] == '=') {
+            if (option.has_arg == zoidbol_no_argument) {
+                if (print_errors)
+                    std::fprintf(stderr, "%s: option '--%s' doesn't allow an argument\n", argv[0], option.name);
+                zoidbol_optopt = option.val;
+                return '?';
+            }
+            zoidbol_optarg = const_cast<char*>(name + length + 1);
+        } else if (option.has_arg == zoidbol_required_argument) {
+            if (zoidbol_optind >= argc) {
+                if (print_errors)
+                    std::fprintf(stderr, "%s: option '--%s' requires an argument\n", argv[0], option.name);
+                zoidbol_optopt = option.val;
+                return missing_argument(optstring);
+            }
+            zoidbol_optarg = argv[zoidbol_optind++];
+        }
+
+        if (longindex != nullptr)
+            *longindex = found;
+        if (option.flag != nullptr) {
+            *option.flag = option.val;
+            return 0;
+        }
+        return option.val;
+    }
+
+} // namespace
+
+int zoidbol_getopt_long(int argc, char* const argv_[], const char* optstring, const struct zoidbol_option* longopts, int* longindex)
+{
+    /* Permuting argv is part of the getopt contract despite the const. */
+    char** argv = const_cast<char**>(argv_);
+
+    if (argc < 1)
+        return -1;
+
+    zoidbol_optarg = nullptr;
+
+    /* A new scan may use different tables at the same addresses, so
+     * everything derived from them is rebuilt. */
+    bool reinitialize = zoidbol_optind == 0 || !state.initialized;
+    if (reinitialize) {
+        if (zoidbol_optind == 0)
+            zoidbol_optind = 1;
+        state.first_nonopt = state.last_nonopt = zoidbol_optind;
+        state.nextchar = nullptr;
+
+        if (optstring[0] == '-')
+            state.ordering = RETURN_IN_ORDER;
+        else if (optstring[0] == '+' || std::getenv("POSIXLY_CORRECT") != nullptr)
+            state.ordering = REQUIRE_ORDER;
+        else
+            state.ordering = PERMUTE;
+
+        state.initialized = true;
+    }
+    if (optstring[0] == '-' || optstring[0] == '+')
+        ++optstring;
+    bool print_errors = zoidbol_opterr != 0 && optstring[0] != ':';
+
+    if (reinitialize || optstring != state.optstring)
+        build_modes(optstring);
+    if (reinitialize || longopts != state.longopts.table())
+        state.longopts.build(longopts);
+
+    if (state.nextchar == nullptr || *state.nextchar == '\0') {
+        /* optind may have been moved back by the caller. */
+        if (state.last_nonopt > zoidbol_optind)
+            state.last_nonopt = zoidbol_optind;
+        if (state.first_nonopt > zoidbol_optind)
+            state.first_nonopt = zoidbol_optind;
+
+        if (state.ordering == PERMUTE) {
+            if (state.first_nonopt != state.last_nonopt && state.last_nonopt != zoidbol_optind)
+                exchange(argv);
+            else if (state.last_nonopt != zoidbol_optind)
+                state.first_nonopt = zoidbol_optind;
+
+            while (zoidbol_optind < argc && is_nonoption(argv[zoidbol_optind])) {
+                ++zoidbol_optind;
+            }
+            state.last_nonopt = zoidbol_optind;
+        }
+
+        /* "--" ends the options, anything after it is a non option. */
+        if (zoidbol_optind != argc && std::strcmp(argv[zoidbol_optind], "--") == 0) {
+            ++zoidbol_optind;
+            if (state.first_nonopt != state.last_nonopt && state.last_nonopt != zoidbol_optind)
+                exchange(argv);
+            else if (state.first_nonopt == state.last_nonopt)
+                state.first_nonopt = zoidbol_optind;
+            state.last_nonopt = argc;
+            zoidbol_optind = argc;
+        }
+
+        if (zoidbol_optind == argc) {
+            /* Point at the non options moved to the end. */
+            if (state.first_nonopt != state.last_nonopt)
+                zoidbol_optind = state.first_nonopt;
+            return -1;
+        }
+
+        if (is_nonoption(argv[zoidbol_optind])) {
+            if (state.ordering == REQUIRE_ORDER)
+                return -1;
+            zoidbol_optarg = argv[zoidbol_optind++];
+            return 1;
+        }
+
+        if (longopts != nullptr && argv[zoidbol_optind][1] == '-') {
+            state.nextchar = argv[zoidbol_optind] + 2;
+            return long_option(argc, argv, optstring, longopts, longindex, print_errors);
+        }
+
+        state.nextchar = argv[zoidbol_optind] + 1;
+    }
+
+    /* Next character of a short option cluster. */
+    unsigned char ch = static_cast<unsigned char>(*state.nextchar++);
+    ShortMode mode = static_cast<ShortMode>(state.modes[ch]);
+
+    if (*state.nextchar == '\0')
+        ++zoidbol_optind;
+
+    if (mode == SHORT_NONE) {
+        if (print_errors)
+            std::fprintf(stderr, "%s: invalid option -- '%c'\n", argv[0], ch);
+        zoidbol_optopt = ch;
+        return '?';
+    }
+
+    int result = ch;
+    if (mode == SHORT_OPTIONAL) {
+        if (*state.nextchar != '\0') {
+            zoidbol_optarg = state.nextchar;
+            ++zoidbol_optind;
+        }
+        state.nextchar = nullptr;
+    } else if (mode == SHORT_REQUIRED) {
+        if (*state.nextchar != '\0') {
+            zoidbol_optarg = state.nextchar;
+            ++zoidbol_optind;
+        } else if (zoidbol_optind == argc) {
+            if (print_errors)
+                std::fprintf(stderr, "%s: option requires an argument -- '%c'\n", argv[0], ch);
+            zoidbol_optopt = ch;
+            result = missing_argument(optstring);
+        } else {
+            zoidbol_optarg = argv[zoidbol_optind++];
+        }
+        state.nextchar = nullptr;
+    }
+    return result;
+}
+
+int zoidbol_getopt(int argc, char* const argv[], const char* optstring)
+{
+    return zoidbol_getopt_long(argc, argv, optstring, nullptr, nullptr);
+}
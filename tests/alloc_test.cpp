@@ -0,0 +1,132 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+
+#include <zoidbol/CommandLineError.hpp>
+#include <zoidbol/CommandLineOption.hpp>
+#include <zoidbol/CommandLineParser.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <typeinfo>
+
+using std::cout;
+using std::endl;
+
+using namespace zoidbol;
+
+static std::size_t allocations = 0;
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+int main(int argc, char* argv[])
+{
+    cout << "argc: " << argc << endl;
+    for (int i = 0; i < argc; ++i) {
+        cout << "argv[" << i << "]: " << '"' << argv[i] << '"' << endl;
+    }
+
+    std::size_t before = allocations;
+
+    zoidbol::FixedCommandLineParser parser;
+
+    zoidbol::FixedCommandLineOption boolean_flag({"b", "boolean"}, "false", "Set a boolean flag.", zoidbol::FixedCommandLineOption::NO_ARGUMENT);
+    zoidbol::FixedCommandLineOption string_flag({"s", "string"}, "", "Set a flag to value.", zoidbol::FixedCommandLineOption::ARGUMENT_REQUIRED);
+    zoidbol::FixedCommandLineOption number_flag({"n", "number"}, "0", "Set a number.", zoidbol::FixedCommandLineOption::ARGUMENT_REQUIRED);
+
+    parser
+        .add_option(&boolean_flag)
+        .add_option(&string_flag)
+        .add_option(&number_flag)
+        ;
+
+    parser.parse(argc, argv);
+
+    bool boolean_value = boolean_flag.to_bool();
+    bool string_value = !string_flag.to_string().empty();
+    int number_value = number_flag.to_int();
+    std::size_t remaining = parser.arguments().size();
+
+    std::size_t after = allocations;
+
+    cout
+    << "boolean_flag.to_bool(): " << (boolean_value ? "true" : "false") << endl
+    << "string_flag.to_string(): \"" << string_flag.to_string() << "\"" << endl
+    << "number_flag.to_int(): " << number_value << endl
+    << "parser.arguments().size(): " << remaining << endl
+    << "allocations: " << (after - before) << endl;
+
+    if (after != before) {
+        cout << "return EXIT_FAILURE: parsing allocated" << endl;
+        return EXIT_FAILURE;
+    }
+    if (!boolean_value || !string_value) {
+        cout << "return EXIT_FAILURE: flags not set" << endl;
+        return EXIT_FAILURE;
+    }
+
+    /* Overflowing a capacity must fail as a CommandLineError. */
+    zoidbol::BasicFixedCommandLineParser<4, zoidbol::BasicFixedCommandLineOption<8, 4>> small_parser;
+    const char* long_argv[] = {"alloc_test", "this-argument-is-longer-than-eight"};
+    try {
+        small_parser.parse(2, long_argv);
+        cout << "small_parser.parse() did not throw CommandLineError" << endl;
+        return EXIT_FAILURE;
+    } catch (CommandLineError& ex) {
+        cout << "small_parser.parse(): CommandLineError: " << ex.what() << endl;
+    }
+
+    /* So must a program name longer than the string capacity, as from a
+     * deep build tree. */
+    std::string long_path = "/" + std::string(200, 'd') + "/alloc_test";
+    const char* long_path_argv[] = {long_path.c_str(), "-b"};
+    try {
+        zoidbol::FixedCommandLineParser path_parser;
+        path_parser.parse(2, long_path_argv);
+        cout << "parse() with a " << long_path.size() << " character argv[0] did not throw CommandLineError" << endl;
+        return EXIT_FAILURE;
+    } catch (CommandLineError& ex) {
+        cout << "parse() with a long argv[0]: CommandLineError: " << ex.what() << endl;
+    } catch (std::exception& ex) {
+        cout << "parse() with a long argv[0] threw " << typeid(ex).name() << " instead of CommandLineError" << endl;
+        return EXIT_FAILURE;
+    }
+
+    /* The argument list capacity belongs to the parser, not the option's
+     * flag list. */
+    const char* many_argv[65] = {"alloc_test"};
+    for (std::size_t i = 1; i < sizeof(many_argv) / sizeof(many_argv[0]); ++i) {
+        many_argv[i] = "-b";
+    }
+    zoidbol::FixedCommandLineParser many_parser;
+    many_parser.add_option(&boolean_flag);
+    many_parser.parse(65, many_argv);
+
+    zoidbol::BasicFixedCommandLineParser<4, zoidbol::FixedCommandLineOption, 8> few_parser;
+    try {
+        few_parser.parse(10, many_argv);
+        cout << "few_parser.parse() with 9 arguments did not throw CommandLineError" << endl;
+        return EXIT_FAILURE;
+    } catch (CommandLineError& ex) {
+        cout << "few_parser.parse(): CommandLineError: " << ex.what() << endl;
+    }
+
+    return EXIT_SUCCESS;
+}
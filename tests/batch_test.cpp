@@ -0,0 +1,199 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+
+#include <zoidbol/BatchParser.hpp>
+#include <zoidbol/CommandLineError.hpp>
+#include <zoidbol/CommandLineOption.hpp>
+#include <zoidbol/CommandLineParser.hpp>
+#include <zoidbol/OptionTable.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "test_support.hpp"
+
+#if defined(__GLIBC__)
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+
+using std::cout;
+using std::endl;
+
+using namespace zoidbol;
+
+typedef std::vector<std::string> Arguments;
+typedef zoidbol::BatchParser<zoidbol::StdCommandLineOption> Batch;
+
+static const char* tokens[] = {
+    "-b", "-v", "-bv", "-vb", "-s", "-sval", "-bsval", "-n", "-n7", "-x", "-",
+    "--boolean", "--verbose", "--string", "--string=eq", "--string=", "--number=42",
+    "--number", "--unknown", "--unknown=1", "--bool", "--",
+    "-o", "-oval", "-bo", "--optional", "--optional=", "--optional=x", "--opt",
+    "value", "42", "file.txt", "-1",
+};
+
+#if defined(__GLIBC__)
+/* How many more threads may start, -1 for no limit. */
+static std::atomic<int> thread_starts_allowed(-1);
+
+/* Interposed so starting a thread can fail like at the process limit. */
+extern "C" int pthread_create(pthread_t* thread, const pthread_attr_t* attr, void* (*start)(void*), void* arg)
+{
+    typedef int (*create_type)(pthread_t*, const pthread_attr_t*, void* (*)(void*), void*);
+    static create_type real_create = reinterpret_cast<create_type>(dlsym(RTLD_NEXT, "pthread_create"));
+
+    int allowed = thread_starts_allowed.load();
+    while (allowed > 0 && !thread_starts_allowed.compare_exchange_weak(allowed, allowed - 1)) {
+    }
+    if (allowed == 0)
+        return EAGAIN;
+    return real_create(thread, attr, start, arg);
+}
+#endif
+
+static bool same(const Batch::Results& lhs, const Batch::Results& rhs)
+{
+    if (lhs.invocations.size() != rhs.invocations.size() || lhs.matches.size() != rhs.matches.size())
+        return false;
+    for (size_t i = 0; i < lhs.invocations.size(); ++i) {
+        const Batch::Invocation& l = lhs.invocations[i];
+        const Batch::Invocation& r = rhs.invocations[i];
+        if (l.first_match != r.first_match || l.match_count != r.match_count || l.first_operand != r.first_operand
+            || l.operand_count != r.operand_count || l.unknown != r.unknown || l.error != r.error)
+            return false;
+    }
+    for (size_t i = 0; i < lhs.matches.size(); ++i) {
+        const Batch::Match& l = lhs.matches[i];
+        const Batch::Match& r = rhs.matches[i];
+        if (l.option != r.option || l.value_argument != r.value_argument || l.value_offset != r.value_offset)
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    cout << "invocations: " << count << " hardware threads: " << threads << endl;
+
+    /* The recorded (option, value) pairs of the current CommandLineParser run. */
+    std::vector<std::pair<size_t, std::string>> called;
+
+    std::vector<zoidbol::StdCommandLineOption> options;
+    options.push_back(zoidbol::StdCommandLineOption({"b", "boolean"}, "false", "Set a boolean flag.", zoidbol::StdCommandLineOption::NO_ARGUMENT, [&called](const std::string& v) { called.push_back(std::make_pair(0, v)); return true; }));
+    options.push_back(zoidbol::StdCommandLineOption({"v", "verbose"}, "false", "Be verbose.", zoidbol::StdCommandLineOption::NO_ARGUMENT, [&called](const std::string& v) { called.push_back(std::make_pair(1, v)); return true; }));
+    options.push_back(zoidbol::StdCommandLineOption({"s", "string"}, "", "Set a flag to value.", zoidbol::StdCommandLineOption::ARGUMENT_REQUIRED, [&called](const std::string& v) { called.push_back(std::make_pair(2, v)); return true; }));
+    options.push_back(zoidbol::StdCommandLineOption({"n", "number"}, "0", "Set a number.", zoidbol::StdCommandLineOption::ARGUMENT_REQUIRED, [&called](const std::string& v) { called.push_back(std::make_pair(3, v)); return true; }));
+    options.push_back(zoidbol::StdCommandLineOption({"o", "optional"}, "", "Set an optional value.", zoidbol::StdCommandLineOption::ARGUMENT_OPTIONAL, [&called](const std::string& v) { called.push_back(std::make_pair(4, v)); return true; }));
+
+    zoidbol::OptionTable<zoidbol::StdCommandLineOption> table;
+    for (size_t i = 0; i < options.size(); ++i) {
+        table.add(options[i]);
+    }
+    Batch batch(table);
+
+    std::vector<Arguments> invocations = random_argument_lists(tokens, count);
+
+    int failures = 0;
+
+    /* Differential check against CommandLineParser. */
+    size_t checked = std::min<size_t>(count, 20000);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < checked; ++i) {
+        const Arguments& args = invocations[i];
+
+        called.clear();
+        zoidbol::StdCommandLineParser parser;
+        for (size_t o = 0; o < options.size(); ++o) {
+            parser.add_option(&options[o]);
+        }
+        bool threw = false;
+        try {
+            parser.parse(args);
+        } catch (CommandLineError&) {
+            threw = true;
+        }
+
+        std::vector<Batch::Match> matches;
+        Batch::Invocation result = batch.parse_one(args, matches);
+
+        bool ok = threw == (result.error != Batch::PARSED_OK) && called.size() == matches.size();
+        for (size_t m = 0; ok && m < matches.size(); ++m) {
+            std::string value = matches[m].value_argument == Batch::npos ? "true" : args[matches[m].value_argument].c_str() + matches[m].value_offset;
+            ok = called[m].first == matches[m].option && called[m].second == value;
+        }
+        if (ok && !threw) {
+            Arguments operands(args.begin() + result.first_operand, args.begin() + result.first_operand + result.operand_count);
+            ok = operands == parser.arguments();
+        }
+        if (!ok) {
+            cout << "invocation " << i << " differs from CommandLineParser:";
+            for (size_t a = 0; a < args.size(); ++a) {
+                cout << " \"" << args[a] << "\"";
+            }
+            cout << endl;
+            ++failures;
+        }
+    }
+    double parser_seconds = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    Batch::Results serial = batch.parse(invocations, 1);
+    double serial_seconds = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    Batch::Results parallel = batch.parse(invocations, threads);
+    double parallel_seconds = seconds_since(start);
+
+    Batch::Results odd = batch.parse(invocations, 3);
+
+#if defined(__GLIBC__)
+    /* Only one of the 7 extra threads starts, the rest of the work is shared. */
+    thread_starts_allowed = 1;
+    Batch::Results limited;
+    try {
+        limited = batch.parse(invocations, 8);
+    } catch (std::exception& ex) {
+        cout << "parse() with failing thread starts threw: " << ex.what() << endl;
+        ++failures;
+    }
+    thread_starts_allowed = -1;
+    if (!same(serial, limited)) {
+        cout << "results differ when threads fail to start" << endl;
+        ++failures;
+    }
+#endif
+
+    cout
+    << "CommandLineParser: " << (checked / parser_seconds) << " invocations/s" << endl
+    << "BatchParser, 1 thread: " << (count / serial_seconds) << " invocations/s" << endl
+    << "BatchParser, " << threads << " threads: " << (count / parallel_seconds) << " invocations/s" << endl
+    << "matches: " << serial.matches.size() << endl
+    << endl;
+
+    if (serial.invocations.size() != count || !same(serial, parallel) || !same(serial, odd)) {
+        cout << "parallel results differ from the serial results" << endl;
+        ++failures;
+    }
+    for (size_t i = 0; i < checked; ++i) {
+        std::vector<Batch::Match> matches;
+        Batch::Invocation result = batch.parse_one(invocations[i], matches);
+        if (result.match_count != serial.invocations[i].match_count
+            || (result.match_count > 0 && std::memcmp(matches.data(), &serial.matches[serial.invocations[i].first_match], sizeof(Batch::Match) * result.match_count) != 0)) {
+            cout << "parse() result " << i << " differs from parse_one()" << endl;
+            ++failures;
+            break;
+        }
+    }
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
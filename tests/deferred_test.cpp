@@ -0,0 +1,197 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+
+#include <zoidbol/CommandLineError.hpp>
+#include <zoidbol/CommandLineOption.hpp>
+#include <zoidbol/CommandLineParser.hpp>
+#include <zoidbol/ConcurrentRunner.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::cout;
+using std::endl;
+
+using namespace zoidbol;
+
+int main(int argc, char* argv[])
+{
+    cout << "argc: " << argc << endl;
+    for (int i = 0; i < argc; ++i) {
+        cout << "argv[" << i << "]: " << '"' << argv[i] << '"' << endl;
+    }
+
+    std::atomic<int> calls(0);
+    std::mutex ordered_mutex;
+    std::vector<std::string> ordered;
+
+    /* Each slow callback waits for the other one to arrive, which only
+     * happens if they run concurrently. */
+    std::atomic<int> arrived(0);
+    std::atomic<int> missed(0);
+    auto slow = [&calls, &arrived, &missed](const std::string& value) -> bool {
+        (void)value;
+        ++arrived;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (arrived < 2 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (arrived < 2)
+            ++missed;
+        ++calls;
+        return true;
+    };
+    auto record = [&calls, &ordered, &ordered_mutex](const std::string& value) -> bool {
+        std::lock_guard<std::mutex> lock(ordered_mutex);
+        ordered.push_back(value);
+        ++calls;
+        return true;
+    };
+
+    zoidbol::StdCommandLineParser parser;
+
+    zoidbol::StdCommandLineOption file_flag({"f", "file"}, "", "Open a file.", zoidbol::StdCommandLineOption::ARGUMENT_REQUIRED, slow);
+    zoidbol::StdCommandLineOption host_flag({"H", "host"}, "", "Resolve a host.", zoidbol::StdCommandLineOption::ARGUMENT_REQUIRED, slow);
+    zoidbol::StdCommandLineOption order_flag({"o", "order"}, "", "Run in order.", zoidbol::StdCommandLineOption::ARGUMENT_REQUIRED, record);
+    zoidbol::StdCommandLineOption cert_flag({"c", "cert"}, "", "Load a certificate.", zoidbol::StdCommandLineOption::ARGUMENT_REQUIRED, [&calls](const std::string& value) -> bool {
+        ++calls;
+        throw std::runtime_error("cannot load certificate " + value);
+    });
+    zoidbol::StdCommandLineOption check_flag({"x", "check"}, "", "Check something.", zoidbol::StdCommandLineOption::ARGUMENT_REQUIRED, [&calls](const std::string& value) -> bool {
+        ++calls;
+        throw CommandLineError("check failed for " + value);
+    });
+
+    file_flag.set_independent(true);
+    host_flag.set_independent(true);
+    cert_flag.set_independent(true);
+
+    parser
+        .add_option(&file_flag)
+        .add_option(&host_flag)
+        .add_option(&order_flag)
+        .add_option(&cert_flag)
+        .add_option(&check_flag)
+        .set_deferred_callbacks(true)
+        ;
+
+    parser.parse(argc, argv);
+
+    int failures = 0;
+
+    if (calls != 0 || !file_flag.to_string().empty()) {
+        cout << "parse() ran callbacks with deferred_callbacks()" << endl;
+        ++failures;
+    }
+
+    try {
+        parser.run_callbacks(zoidbol::ConcurrentRunner());
+        cout << "run_callbacks() did not throw" << endl;
+        ++failures;
+    } catch (CommandLineError& ex) {
+        cout << "run_callbacks(): CommandLineError: " << ex.what() << endl;
+    }
+
+    cout
+    << "calls: " << calls << endl
+    << "file_flag.to_string(): \"" << file_flag.to_string() << "\"" << endl
+    << "host_flag.to_string(): \"" << host_flag.to_string() << "\"" << endl
+    << "order_flag.to_string(): \"" << order_flag.to_string() << "\"" << endl
+    << endl;
+
+    if (calls != 7) {
+        cout << "expected 7 callbacks" << endl;
+        ++failures;
+    }
+    if (missed != 0) {
+        cout << "independent callbacks did not run concurrently" << endl;
+        ++failures;
+    }
+    if (file_flag.to_string() != "a.txt" || host_flag.to_string() != "localhost" || order_flag.to_string() != "3") {
+        cout << "option values were not set by run_callbacks()" << endl;
+        ++failures;
+    }
+    if (ordered != std::vector<std::string>({"1", "2", "3"})) {
+        cout << "dependent callbacks did not run in argument order" << endl;
+        ++failures;
+    }
+
+    const zoidbol::StdCommandLineParser::callback_error_list& errors = parser.callback_errors();
+    if (errors.size() != 2 || errors[0].option != &check_flag || errors[0].value != "first" || errors[1].option != &cert_flag || errors[1].value != "second") {
+        cout << "callback_errors() not in argument order" << endl;
+        ++failures;
+    }
+
+    /* Many independent options share a bounded pool of threads, and each
+     * option still sees its values in argument order. */
+    std::mutex many_mutex;
+    std::set<std::thread::id> thread_ids;
+    std::vector<std::vector<std::string>> seen(300);
+    std::vector<zoidbol::StdCommandLineOption> many;
+    many.reserve(seen.size());
+    for (size_t i = 0; i < seen.size(); ++i) {
+        many.push_back(zoidbol::StdCommandLineOption({"many-" + std::to_string(i)}, "", "One of many.", zoidbol::StdCommandLineOption::ARGUMENT_REQUIRED, [i, &seen, &thread_ids, &many_mutex](const std::string& value) -> bool {
+            std::lock_guard<std::mutex> lock(many_mutex);
+            seen[i].push_back(value);
+            thread_ids.insert(std::this_thread::get_id());
+            return true;
+        }));
+        many.back().set_independent(true);
+    }
+    zoidbol::StdCommandLineParser many_parser;
+    std::vector<std::string> many_args;
+    for (size_t i = 0; i < many.size(); ++i) {
+        many_parser.add_option(&many[i]);
+    }
+    for (int round = 0; round < 3; ++round) {
+        for (size_t i = 0; i < many.size(); ++i) {
+            many_args.push_back("--many-" + std::to_string(i) + "=" + std::to_string(round));
+        }
+    }
+    many_parser.set_deferred_callbacks(true);
+    many_parser.parse(many_args);
+    many_parser.run_callbacks(zoidbol::ConcurrentRunner());
+
+    size_t pool_limit = std::max(1u, std::thread::hardware_concurrency()) + 1;
+    cout << "threads used for " << many.size() << " independent options: " << thread_ids.size() << endl;
+    if (thread_ids.size() > pool_limit) {
+        cout << "run_callbacks() used more than " << pool_limit << " threads" << endl;
+        ++failures;
+    }
+    for (size_t i = 0; i < seen.size(); ++i) {
+        if (seen[i] != std::vector<std::string>({"0", "1", "2"})) {
+            cout << "many-" << i << " callbacks did not run once per value in argument order" << endl;
+            ++failures;
+            break;
+        }
+    }
+
+    /* Without a runner every callback runs on the calling thread, in
+     * argument order. */
+    thread_ids.clear();
+    for (size_t i = 0; i < seen.size(); ++i) {
+        seen[i].clear();
+    }
+    many_parser.parse(many_args);
+    many_parser.run_callbacks();
+    if (thread_ids.size() != 1 || *thread_ids.begin() != std::this_thread::get_id()) {
+        cout << "run_callbacks() without a runner left the calling thread" << endl;
+        ++failures;
+    }
+    for (size_t i = 0; i < seen.size(); ++i) {
+        if (seen[i] != std::vector<std::string>({"0", "1", "2"})) {
+            cout << "many-" << i << " serial callbacks did not run once per value in argument order" << endl;
+            ++failures;
+            break;
+        }
+    }
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
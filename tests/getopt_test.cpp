@@ -0,0 +1,295 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+
+#include <zoidbol/getopt.h>
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "test_support.hpp"
+
+using std::cout;
+using std::endl;
+
+typedef std::vector<std::string> Arguments;
+
+static int flag_value = 0;
+
+/* Same entries for both implementations, the layouts are identical. */
+static const struct option long_options[] = {
+    {"verbose", no_argument, nullptr, 'v'},
+    {"version", no_argument, nullptr, 'V'},
+    {"value", required_argument, nullptr, 'x'},
+    {"color", optional_argument, nullptr, 'c'},
+    {"colour", optional_argument, nullptr, 'c'},
+    {"file", required_argument, nullptr, 'f'},
+    {"flag", no_argument, &flag_value, 7},
+    {"f", no_argument, nullptr, 'F'},
+    {"number", required_argument, nullptr, 'n'},
+    {nullptr, 0, nullptr, 0},
+};
+
+static const char* optstrings[] = {
+    "vVx:c::f:n:",
+    "+vVx:c::f:n:",
+    "-vVx:c::f:n:",
+    ":vVx:c::f:n:",
+    "+:vx:",
+    "ab",
+};
+
+static const char* tokens[] = {
+    "-v", "-V", "-vV", "-x", "-xval", "-vxval", "-c", "-cval", "-f", "-n5", "-q", "-vq", "-:", "-",
+    "--verbose", "--version", "--ver", "--verb", "--val=1", "--value", "--value=", "--col", "--col=red",
+    "--colour=blue", "--color", "--fi", "--fl", "--f", "--file=a", "--flag", "--flag=1", "--nu", "--num=3",
+    "--bogus", "--bogus=1", "--v", "--",
+    "operand", "42", "-5", "a.txt",
+};
+
+/** Everything visible after one call. */
+struct Step
+{
+    int result;
+    int optind;
+    std::string optarg;
+    int optopt;
+    int longindex;
+    int flag;
+
+    bool operator==(const Step& rhs) const
+    {
+        bool error = result == '?' || result == ':';
+        return result == rhs.result && optind == rhs.optind && optarg == rhs.optarg && longindex == rhs.longindex
+            && flag == rhs.flag && (!error || optopt == rhs.optopt);
+    }
+};
+
+struct Run
+{
+    std::vector<Step> steps;
+    Arguments argv;
+
+    bool operator==(const Run& rhs) const
+    {
+        return steps.size() == rhs.steps.size() && std::equal(steps.begin(), steps.end(), rhs.steps.begin()) && argv == rhs.argv;
+    }
+};
+
+static std::vector<char*> make_argv(const Arguments& args, std::vector<std::string>& storage)
+{
+    storage.assign(1, "getopt_test");
+    storage.insert(storage.end(), args.begin(), args.end());
+    std::vector<char*> argv;
+    for (std::string& arg : storage) {
+        argv.push_back(&arg[0]);
+    }
+    argv.push_back(nullptr);
+    return argv;
+}
+
+static Run run_glibc(const char* optstring, const Arguments& args, const struct option* longopts)
+{
+    std::vector<std::string> storage;
+    std::vector<char*> argv = make_argv(args, storage);
+    int argc = static_cast<int>(argv.size() - 1);
+    Run run;
+
+    optind = 0;
+    opterr = 0;
+    for (;;) {
+        int longindex = -1;
+        flag_value = 0;
+        optopt = 0;
+        int result = getopt_long(argc, argv.data(), optstring, longopts, &longindex);
+        if (result == -1) {
+            run.steps.push_back({result, optind, "", 0, -1, 0});
+            break;
+        }
+        run.steps.push_back({result, optind, optarg ? optarg : "(null)", optopt, longindex, flag_value});
+    }
+    for (int i = 0; i < argc; ++i) {
+        run.argv.push_back(argv[i]);
+    }
+    return run;
+}
+
+static Run run_zoidbol(const char* optstring, const Arguments& args, const struct option* table)
+{
+    std::vector<std::string> storage;
+    std::vector<char*> argv = make_argv(args, storage);
+    int argc = static_cast<int>(argv.size() - 1);
+    const zoidbol_option* longopts = reinterpret_cast<const zoidbol_option*>(table);
+    Run run;
+
+    zoidbol_optind = 0;
+    zoidbol_opterr = 0;
+    for (;;) {
+        int longindex = -1;
+        flag_value = 0;
+        zoidbol_optopt = 0;
+        int result = zoidbol_getopt_long(argc, argv.data(), optstring, longopts, &longindex);
+        if (result == -1) {
+            run.steps.push_back({result, zoidbol_optind, "", 0, -1, 0});
+            break;
+        }
+        run.steps.push_back({result, zoidbol_optind, zoidbol_optarg ? zoidbol_optarg : "(null)", zoidbol_optopt, longindex, flag_value});
+    }
+    for (int i = 0; i < argc; ++i) {
+        run.argv.push_back(argv[i]);
+    }
+    return run;
+}
+
+static std::string describe(const Run& run)
+{
+    std::ostringstream out;
+    for (const Step& step : run.steps) {
+        out << " (" << step.result << " optind=" << step.optind << " optarg=" << step.optarg << " optopt=" << step.optopt
+            << " longindex=" << step.longindex << " flag=" << step.flag << ")";
+    }
+    out << " argv:";
+    for (const std::string& arg : run.argv) {
+        out << " " << arg;
+    }
+    return out.str();
+}
+
+/** Time both implementations on a large table where most lookups are exact names. */
+static void throughput(size_t options, size_t iterations)
+{
+    std::vector<std::string> names;
+    for (size_t i = 0; i < options; ++i) {
+        names.push_back("option-" + std::to_string(i));
+    }
+    std::vector<struct option> table;
+    for (size_t i = 0; i < options; ++i) {
+        table.push_back({names[i].c_str(), required_argument, nullptr, 256 + static_cast<int>(i)});
+    }
+    table.push_back({nullptr, 0, nullptr, 0});
+
+    Arguments args;
+    for (size_t i = 0; i < 64; ++i) {
+        args.push_back("--" + names[(i * 7919) % options] + "=value");
+    }
+    std::vector<std::string> storage;
+    std::vector<char*> argv = make_argv(args, storage);
+    int argc = static_cast<int>(argv.size() - 1);
+    long checksum[2] = {0, 0};
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < iterations; ++n) {
+        optind = 0;
+        for (int c; (c = getopt_long(argc, argv.data(), "", table.data(), nullptr)) != -1;) {
+            checksum[0] += c;
+        }
+    }
+    double glibc = seconds_since(start);
+
+    const zoidbol_option* longopts = reinterpret_cast<const zoidbol_option*>(table.data());
+    start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < iterations; ++n) {
+        zoidbol_optind = 0;
+        for (int c; (c = zoidbol_getopt_long(argc, argv.data(), "", longopts, nullptr)) != -1;) {
+            checksum[1] += c;
+        }
+    }
+    double zoidbol = seconds_since(start);
+
+    double calls = static_cast<double>(iterations * args.size());
+    cout
+    << "throughput with " << options << " long options:" << endl
+    << "  glibc getopt_long():         " << glibc << "s, " << (glibc / calls * 1e9) << " ns per option" << endl
+    << "  zoidbol_getopt_long():       " << zoidbol << "s, " << (zoidbol / calls * 1e9) << " ns per option" << endl
+    << "  speedup:                     " << (zoidbol > 0 ? glibc / zoidbol : 0) << "x" << endl
+    << "  checksums match:             " << (checksum[0] == checksum[1] ? "yes" : "no") << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+
+    unsetenv("POSIXLY_CORRECT");
+
+    std::vector<Arguments> lists = {
+        {},
+        {"--"},
+        {"a", "-v", "b", "--", "-x", "c"},
+        {"--value"},
+        {"-x"},
+        {"--ver"},
+        {"--col"},
+        {"--f"},
+        {"--fl"},
+        {"--verbose=1"},
+        {"-c", "arg"},
+        {"--color", "arg"},
+        {"-", "-v", "-"},
+        {"a", "b", "-vxval", "c", "--file", "d", "e"},
+    };
+    std::vector<Arguments> generated = random_argument_lists(tokens, count);
+    lists.insert(lists.end(), generated.begin(), generated.end());
+
+    int failures = 0;
+    size_t runs = 0;
+    for (int posixly_correct = 0; posixly_correct < 2; ++posixly_correct) {
+        if (posixly_correct)
+            setenv("POSIXLY_CORRECT", "1", 1);
+        for (const char* optstring : optstrings) {
+            for (int with_long = 0; with_long < 2; ++with_long) {
+                for (const Arguments& args : lists) {
+                    Run expected = run_glibc(optstring, args, with_long ? long_options : nullptr);
+                    Run actual = run_zoidbol(optstring, args, with_long ? long_options : nullptr);
+                    ++runs;
+                    if (actual == expected)
+                        continue;
+                    if (++failures <= 10) {
+                        cout << "mismatch for optstring \"" << optstring << "\"" << (with_long ? " with" : " without") << " long options"
+                             << (posixly_correct ? " and POSIXLY_CORRECT" : "") << ", arguments:";
+                        for (const std::string& arg : args) {
+                            cout << " " << arg;
+                        }
+                        cout << endl
+                             << "  glibc:  " << describe(expected) << endl
+                             << "  zoidbol:" << describe(actual) << endl;
+                    }
+                }
+            }
+        }
+    }
+    unsetenv("POSIXLY_CORRECT");
+
+    /* A different table at the same address, e.g. one built on the stack
+     * by a helper, must not reuse the index of the previous scan. */
+    struct option reused[3];
+    const struct option contents[][3] = {
+        {{"alpha", no_argument, nullptr, 'a'}, {"zeta", no_argument, nullptr, 'Z'}, {nullptr, 0, nullptr, 0}},
+        {{"zeta", no_argument, nullptr, 'z'}, {"alpha", required_argument, nullptr, 'A'}, {nullptr, 0, nullptr, 0}},
+        {{"alpine", no_argument, nullptr, 'p'}, {"alpha", no_argument, nullptr, 'A'}, {nullptr, 0, nullptr, 0}},
+    };
+    const Arguments swapped_args = {"--alpha", "x", "--zeta", "--al", "--alp", "--z"};
+    for (const auto& table : contents) {
+        std::copy(table, table + 3, reused);
+        Run expected = run_glibc("", swapped_args, reused);
+        Run actual = run_zoidbol("", swapped_args, reused);
+        ++runs;
+        if (!(actual == expected)) {
+            cout << "mismatch after changing the table at the same address, starting with --" << table[0].name << endl
+                 << "  glibc:  " << describe(expected) << endl
+                 << "  zoidbol:" << describe(actual) << endl;
+            ++failures;
+        }
+    }
+
+    cout << "differential runs: " << runs << " mismatches: " << failures << endl;
+
+    throughput(2000, 2000);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
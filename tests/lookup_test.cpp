@@ -0,0 +1,177 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+
+#include <zoidbol/CommandLineError.hpp>
+#include <zoidbol/CommandLineOption.hpp>
+#include <zoidbol/CommandLineParser.hpp>
+
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "test_support.hpp"
+
+using std::cout;
+using std::endl;
+
+using namespace zoidbol;
+
+int main(int argc, char* argv[])
+{
+    cout << "argc: " << argc << endl;
+    for (int i = 0; i < argc; ++i) {
+        cout << "argv[" << i << "]: " << '"' << argv[i] << '"' << endl;
+    }
+
+    zoidbol::StdCommandLineParser parser;
+
+    zoidbol::StdCommandLineOption threads_flag({"t", "threads"}, "1", "Number of threads.", zoidbol::StdCommandLineOption::ARGUMENT_REQUIRED);
+    zoidbol::StdCommandLineOption verbose_flag({"v", "verbose"}, "false", "Be verbose.", zoidbol::StdCommandLineOption::NO_ARGUMENT);
+    zoidbol::StdCommandLineOption name_flag({"name"}, "", "A name.", zoidbol::StdCommandLineOption::ARGUMENT_REQUIRED);
+
+    /* Enough extra options to make the index grow a few times. */
+    std::vector<zoidbol::StdCommandLineOption> extra;
+    for (int i = 0; i < 500; ++i) {
+        extra.push_back(zoidbol::StdCommandLineOption({"extra-" + std::to_string(i)}, std::to_string(i), "Extra option.", zoidbol::StdCommandLineOption::ARGUMENT_REQUIRED));
+    }
+
+    parser
+        .add_option(&threads_flag)
+        .add_option(&verbose_flag)
+        .add_option(&name_flag)
+        ;
+    for (size_t i = 0; i < extra.size(); ++i) {
+        parser.add_option(&extra[i]);
+    }
+
+    parser.parse(argc, argv);
+
+    int failures = 0;
+
+    if (parser.get("threads") != &threads_flag || parser.get("t") != &threads_flag) {
+        cout << "get(\"threads\") did not return threads_flag" << endl;
+        ++failures;
+    }
+    if (parser.get(std::string("verbose")) != &verbose_flag) {
+        cout << "get(std::string(\"verbose\")) did not return verbose_flag" << endl;
+        ++failures;
+    }
+    if (parser.get("missing") != nullptr || parser.get("thread") != nullptr) {
+        cout << "get() found an option that does not exist" << endl;
+        ++failures;
+    }
+    for (size_t i = 0; i < extra.size(); ++i) {
+        if (parser.get("extra-" + std::to_string(i)) != &extra[i]) {
+            cout << "get(\"extra-" << i << "\") did not return extra[" << i << "]" << endl;
+            ++failures;
+        }
+    }
+
+    cout
+    << "get_int(\"threads\"): " << parser.get_int("threads") << endl
+    << "get_bool(\"verbose\"): " << (parser.get_bool("verbose") ? "true" : "false") << endl
+    << "get_string(\"name\"): \"" << parser.get_string("name") << "\"" << endl
+    << "get_float(\"extra-7\"): " << parser.get_float("extra-7") << endl
+    << endl;
+
+    if (parser.get_int("threads") != 8 || !parser.get_bool("v") || parser.get_string("name") != "zoidberg") {
+        cout << "typed get values do not match the command line" << endl;
+        ++failures;
+    }
+    if (parser.get_int("extra-42") != 42) {
+        cout << "get_int(\"extra-42\") != 42" << endl;
+        ++failures;
+    }
+
+    try {
+        parser.get_int("missing");
+        cout << "get_int(\"missing\") did not throw" << endl;
+        ++failures;
+    } catch (std::out_of_range& ex) {
+        cout << "get_int(\"missing\"): std::out_of_range: " << ex.what() << endl;
+    }
+
+    /* Fixed capacity: the index is sized for 4 flags per option. */
+    zoidbol::FixedCommandLineOption a_flag({"a", "alpha", "first", "one"}, "", "A.", zoidbol::FixedCommandLineOption::NO_ARGUMENT);
+    zoidbol::FixedCommandLineOption b_flag({"b", "beta", "second", "two"}, "", "B.", zoidbol::FixedCommandLineOption::NO_ARGUMENT);
+    zoidbol::FixedCommandLineOption c_flag({"c", "gamma", "third", "three"}, "", "C.", zoidbol::FixedCommandLineOption::NO_ARGUMENT);
+    zoidbol::FixedCommandLineOption d_flag({"d", "delta"}, "", "D.", zoidbol::FixedCommandLineOption::NO_ARGUMENT);
+
+    zoidbol::BasicFixedCommandLineParser<1> one;
+    try {
+        one.add_option(&a_flag);
+    } catch (CommandLineError& ex) {
+        cout << "BasicFixedCommandLineParser<1>::add_option(): CommandLineError: " << ex.what() << endl;
+        ++failures;
+    }
+    try {
+        one.add_option(&b_flag);
+        cout << "BasicFixedCommandLineParser<1> accepted a second option" << endl;
+        ++failures;
+    } catch (CommandLineError& ex) {
+        cout << "BasicFixedCommandLineParser<1>: second option: CommandLineError: " << ex.what() << endl;
+    }
+    if (one.options().size() != 1 || one.get("alpha") != &a_flag || one.get("b") != nullptr || one.get("beta") != nullptr) {
+        cout << "a failed add_option() left BasicFixedCommandLineParser<1> changed" << endl;
+        ++failures;
+    }
+
+    zoidbol::BasicFixedCommandLineParser<3> three;
+    try {
+        three.add_option(&a_flag).add_option(&b_flag).add_option(&c_flag);
+    } catch (CommandLineError& ex) {
+        cout << "BasicFixedCommandLineParser<3>::add_option(): CommandLineError: " << ex.what() << endl;
+        ++failures;
+    }
+    try {
+        three.add_option(&d_flag);
+        cout << "BasicFixedCommandLineParser<3> accepted a fourth option" << endl;
+        ++failures;
+    } catch (CommandLineError& ex) {
+        cout << "BasicFixedCommandLineParser<3>: fourth option: CommandLineError: " << ex.what() << endl;
+    }
+    if (three.options().size() != 3 || three.get("three") != &c_flag || three.get("d") != nullptr || three.get("delta") != nullptr) {
+        cout << "a failed add_option() left BasicFixedCommandLineParser<3> changed" << endl;
+        ++failures;
+    }
+
+    /* FlagIndex::erase() against std::map. */
+    std::vector<std::string> keys;
+    for (int i = 0; i < 300; ++i) {
+        keys.push_back("key-" + std::to_string(i));
+    }
+    zoidbol::FlagIndex<int> index;
+    std::map<std::string, int> expected;
+    Random random;
+    for (int step = 0; step < 20000; ++step) {
+        const std::string& key = keys[random.below(keys.size())];
+        if (random.below(2) == 1) {
+            bool inserted = index.insert(key.c_str(), key.size(), step);
+            if (inserted != expected.insert(std::make_pair(key, step)).second) {
+                cout << "FlagIndex::insert(\"" << key << "\") disagrees with std::map" << endl;
+                ++failures;
+                break;
+            }
+        } else if (index.erase(key.c_str(), key.size()) != (expected.erase(key) == 1)) {
+            cout << "FlagIndex::erase(\"" << key << "\") disagrees with std::map" << endl;
+            ++failures;
+            break;
+        }
+    }
+    for (const std::string& key : keys) {
+        const int* found = index.find(key.c_str(), key.size());
+        std::map<std::string, int>::const_iterator it = expected.find(key);
+        if ((found == nullptr) != (it == expected.end()) || (found != nullptr && *found != it->second)) {
+            cout << "FlagIndex::find(\"" << key << "\") disagrees with std::map after erase()" << endl;
+            ++failures;
+            break;
+        }
+    }
+    if (index.size() != expected.size()) {
+        cout << "FlagIndex::size() disagrees with std::map after erase()" << endl;
+        ++failures;
+    }
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,101 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+
+#include <zoidbol/CommandLineError.hpp>
+#include <zoidbol/CommandLineOption.hpp>
+#include <zoidbol/CommandLineParser.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+
+using namespace zoidbol;
+
+typedef std::vector<std::string> Arguments;
+
+struct Case
+{
+    Arguments args;
+    /* The values passed to the optional option's callback, in order. */
+    Arguments values;
+    bool boolean;
+    Arguments operands;
+};
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    const Case cases[] = {
+        {{"--optional"}, {"true"}, false, {}},
+        {{"-o"}, {"true"}, false, {}},
+        {{"--optional", "bar"}, {"bar"}, false, {}},
+        {{"-o", "bar"}, {"bar"}, false, {}},
+        {{"-obar"}, {"bar"}, false, {}},
+        {{"-bobar"}, {"bar"}, true, {}},
+        {{"-bo", "bar"}, {"bar"}, true, {}},
+        {{"--optional=bar"}, {"bar"}, false, {}},
+        {{"--optional="}, {""}, false, {}},
+        {{"--optional=", "bar"}, {""}, false, {"bar"}},
+        {{"--optional", "-b"}, {"true"}, true, {}},
+        {{"-o", "-b"}, {"true"}, true, {}},
+        {{"-o", "-bs", "x"}, {"true"}, true, {}},
+        {{"--optional", "--boolean"}, {"true"}, true, {}},
+        {{"-o", "--string=x"}, {"true"}, false, {}},
+        {{"--optional", "-5"}, {"-5"}, false, {}},
+        {{"-o", "-1.5"}, {"-1.5"}, false, {}},
+        {{"--optional", "-"}, {"-"}, false, {}},
+        {{"--optional", "--unknown"}, {"--unknown"}, false, {}},
+        {{"--optional", "--"}, {"true"}, false, {}},
+        {{"-o", "x", "-o"}, {"x", "true"}, false, {}},
+        {{"-o", "-o"}, {"true", "true"}, false, {}},
+        {{"-o", "-b", "operand"}, {"true"}, true, {"operand"}},
+    };
+
+    int failures = 0;
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        Arguments values;
+
+        zoidbol::StdCommandLineParser parser;
+        zoidbol::StdCommandLineOption boolean_flag({"b", "boolean"}, "false", "Set a boolean flag.", zoidbol::StdCommandLineOption::NO_ARGUMENT);
+        zoidbol::StdCommandLineOption string_flag({"s", "string"}, "", "Set a flag to value.", zoidbol::StdCommandLineOption::ARGUMENT_REQUIRED);
+        zoidbol::StdCommandLineOption optional_flag({"o", "optional"}, "", "Value is optional.", zoidbol::StdCommandLineOption::ARGUMENT_OPTIONAL, [&values](const std::string& value) -> bool {
+            values.push_back(value);
+            return true;
+        });
+        parser.add_option(&boolean_flag).add_option(&string_flag).add_option(&optional_flag);
+
+        try {
+            parser.parse(cases[i].args);
+        } catch (CommandLineError& ex) {
+            cout << "case " << i << ": CommandLineError: " << ex.what() << endl;
+            ++failures;
+            continue;
+        }
+
+        if (values != cases[i].values || boolean_flag.to_bool() != cases[i].boolean || parser.arguments() != cases[i].operands) {
+            cout << "case " << i << ":";
+            for (const std::string& arg : cases[i].args) {
+                cout << " [" << arg << "]";
+            }
+            cout << " gave values";
+            for (const std::string& value : values) {
+                cout << " [" << value << "]";
+            }
+            cout << " boolean " << (boolean_flag.to_bool() ? "true" : "false") << " operands";
+            for (const std::string& operand : parser.arguments()) {
+                cout << " [" << operand << "]";
+            }
+            cout << endl;
+            ++failures;
+        }
+    }
+
+    cout << "cases: " << (sizeof(cases) / sizeof(cases[0])) << " failures: " << failures << endl;
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,127 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+
+#include <zoidbol/CommandLineOption.hpp>
+#include <zoidbol/CommandLineParser.hpp>
+#include <zoidbol/OptionTable.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+
+using namespace zoidbol;
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5000;
+    cout << "options: " << count << endl;
+
+    std::vector<zoidbol::StdCommandLineOption> options;
+    options.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::vector<std::string> flags;
+        if (i < 26)
+            flags.push_back(std::string(1, static_cast<char>('a' + i)));
+        flags.push_back("generated-option-" + std::to_string(i));
+        flags.push_back("alias-" + std::to_string(i));
+        std::string help = "Generated option from group " + std::to_string(i % 50) + ", takes a value.";
+        options.push_back(zoidbol::StdCommandLineOption(flags, std::to_string(i % 10), help, zoidbol::StdCommandLineOption::ARGUMENT_REQUIRED));
+    }
+
+    zoidbol::StdCommandLineParser parser;
+    for (size_t i = 0; i < options.size(); ++i) {
+        parser.add_option(&options[i]);
+    }
+
+    zoidbol::OptionTable<zoidbol::StdCommandLineOption> table;
+    table.add(parser.options().begin(), parser.options().end());
+
+    MemoryUsage old_usage;
+    for (size_t i = 0; i < options.size(); ++i) {
+        old_usage += zoidbol::memory_usage(options[i]);
+    }
+    MemoryUsage new_usage = table.memory_usage();
+    table.shrink_to_fit();
+    MemoryUsage shrunk_usage = table.memory_usage();
+
+    cout
+    << "CommandLineOption: " << old_usage.bytes << " bytes in " << old_usage.blocks << " heap blocks" << endl
+    << "OptionTable: " << new_usage.bytes << " bytes in " << new_usage.blocks << " heap blocks" << endl
+    << "OptionTable after shrink_to_fit(): " << shrunk_usage.bytes << " bytes in " << shrunk_usage.blocks << " heap blocks" << endl
+    << "OptionTable pool: " << table.pool_size() << " bytes" << endl
+    << "sizeof(OptionTable::Record): " << sizeof(zoidbol::OptionTable<zoidbol::StdCommandLineOption>::Record) << endl
+    << endl;
+
+    int failures = 0;
+
+    if (table.size() != options.size()) {
+        cout << "table.size() != options.size()" << endl;
+        ++failures;
+    }
+    for (size_t i = 0; i < options.size(); ++i) {
+        const zoidbol::StdCommandLineOption& opt = options[i];
+        for (size_t f = 0; f < opt.flags().size(); ++f) {
+            if (table.find(opt.flags()[f].c_str()) != i) {
+                cout << "table.find(\"" << opt.flags()[f] << "\") != " << i << endl;
+                ++failures;
+            }
+            if (opt.flags()[f] != table.flag(static_cast<zoidbol::OptionTable<zoidbol::StdCommandLineOption>::index_type>(i), f)) {
+                cout << "table.flag(" << i << ", " << f << ") != \"" << opt.flags()[f] << "\"" << endl;
+                ++failures;
+            }
+        }
+        if (opt.help() != table.help(static_cast<zoidbol::OptionTable<zoidbol::StdCommandLineOption>::index_type>(i))
+            || opt.value() != table.value(static_cast<zoidbol::OptionTable<zoidbol::StdCommandLineOption>::index_type>(i))
+            || opt.mode() != table.mode(static_cast<zoidbol::OptionTable<zoidbol::StdCommandLineOption>::index_type>(i))) {
+            cout << "table record " << i << " does not match the option" << endl;
+            ++failures;
+        }
+    }
+    if (table.find("missing") != table.npos) {
+        cout << "table.find(\"missing\") != npos" << endl;
+        ++failures;
+    }
+
+    if (shrunk_usage.bytes >= old_usage.bytes || shrunk_usage.blocks >= old_usage.blocks) {
+        cout << "OptionTable is not smaller than the CommandLineOption layout" << endl;
+        ++failures;
+    }
+
+    /* Flags with the same 32 bit hash stay distinct, and comparing them
+     * does not read past a shorter string at the end of the pool. */
+    std::map<std::uint32_t, std::string> seen;
+    std::string shorter;
+    std::string longer;
+    for (unsigned long i = 0; shorter.empty(); ++i) {
+        std::string candidate = std::string(i % 16, 'x') + std::to_string(i);
+        std::uint32_t h = static_cast<std::uint32_t>(zoidbol::FlagIndex<int>::hash(candidate.c_str(), candidate.size()));
+        std::map<std::uint32_t, std::string>::const_iterator it = seen.find(h);
+        if (it == seen.end()) {
+            seen.insert(std::make_pair(h, candidate));
+        } else if (it->second.size() + 2 <= candidate.size() || candidate.size() + 2 <= it->second.size()) {
+            shorter = it->second.size() < candidate.size() ? it->second : candidate;
+            longer = it->second.size() < candidate.size() ? candidate : it->second;
+        }
+    }
+    cout << "colliding flags: \"" << shorter << "\" and \"" << longer << "\"" << endl;
+
+    zoidbol::StdCommandLineOption short_flag({shorter}, "", "", zoidbol::StdCommandLineOption::NO_ARGUMENT);
+    zoidbol::StdCommandLineOption long_flag({longer}, "", "", zoidbol::StdCommandLineOption::NO_ARGUMENT);
+    zoidbol::OptionTable<zoidbol::StdCommandLineOption> colliding;
+    colliding.add(short_flag);
+    colliding.shrink_to_fit();
+    colliding.add(long_flag);
+    if (colliding.find(shorter.c_str()) != 0 || colliding.find(longer.c_str()) != 1 || longer != colliding.flag(1, 0)
+        || colliding.pool_size() != shorter.size() + longer.size() + 3) {
+        cout << "colliding flags were not interned separately" << endl;
+        ++failures;
+    }
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,56 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+#ifndef ZOIDBOL_TESTS_TEST_SUPPORT__HPP
+#define ZOIDBOL_TESTS_TEST_SUPPORT__HPP
+
+/* Helpers shared by the tests. */
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/** Deterministic pseudo random numbers, the same sequence everywhere.
+ */
+class Random
+{
+  public:
+    explicit Random(unsigned long long seed = 42)
+        : mState(seed)
+    {
+    }
+
+    /** @returns a number in [0, bound).
+     */
+    std::size_t below(std::size_t bound)
+    {
+        mState = mState * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<std::size_t>((mState >> 33) % bound);
+    }
+
+  private:
+    unsigned long long mState;
+};
+
+/** @returns count argument lists of 0 to 8 arguments each, drawn from
+ * tokens.
+ */
+template <std::size_t N>
+std::vector<std::vector<std::string>> random_argument_lists(const char* const (&tokens)[N], std::size_t count)
+{
+    Random random;
+    std::vector<std::vector<std::string>> result(count);
+    for (std::vector<std::string>& args : result) {
+        std::size_t length = random.below(9);
+        for (std::size_t j = 0; j < length; ++j) {
+            args.push_back(tokens[random.below(N)]);
+        }
+    }
+    return result;
+}
+
+inline double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+#endif // ZOIDBOL_TESTS_TEST_SUPPORT__HPP
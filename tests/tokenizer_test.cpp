@@ -0,0 +1,117 @@
+// vim: set filetype=cpp tabstop=4 shiftwidth=4 expandtab :
+
+#include <zoidbol/CommandLineError.hpp>
+#include <zoidbol/CommandLineOption.hpp>
+#include <zoidbol/CommandLineParser.hpp>
+#include <zoidbol/ShellTokenizer.hpp>
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+
+using namespace zoidbol;
+
+struct Case
+{
+    const char* input;
+    std::vector<std::string> expected;
+};
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    const Case cases[] = {
+        {"", {}},
+        {"   \t\n ", {}},
+        {"a b  c", {"a", "b", "c"}},
+        {"  leading and trailing  ", {"leading", "and", "trailing"}},
+        {"'single quoted' word", {"single quoted", "word"}},
+        {"'it''s' 'a\\b'", {"its", "a\\b"}},
+        {"\"double $quoted\" \"esc\\\"aped\" \"keep\\n\"", {"double $quoted", "esc\"aped", "keep\\n"}},
+        {"\"\\$\\`\\\\\"", {"$`\\"}},
+        {"back\\ slash \\'x\\'", {"back slash", "'x'"}},
+        {"con\"cat\"'en'ated", {"concatenated"}},
+        {"'' \"\" x", {"", "", "x"}},
+        {"line \\\ncontinued", {"line", "continued"}},
+        {"word\\\njoined", {"wordjoined"}},
+        {"\"quoted\\\njoined\"", {"quotedjoined"}},
+        {"cmd # comment here\nnext", {"cmd", "next"}},
+        {"not#comment", {"not#comment"}},
+        {"--name='Zapp Brannigan' -v", {"--name=Zapp Brannigan", "-v"}},
+    };
+    const char* errors[] = {
+        "'unterminated",
+        "\"unterminated",
+        "trailing\\",
+    };
+
+    int failures = 0;
+    zoidbol::ShellTokenizer<> tokenizer;
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        std::vector<char> buffer(cases[i].input, cases[i].input + std::strlen(cases[i].input) + 1);
+        tokenizer.tokenize(buffer.data());
+
+        std::vector<std::string> actual;
+        for (size_t a = 0; a < tokenizer.size(); ++a) {
+            const ArgumentView& arg = tokenizer.arguments()[a];
+            actual.push_back(std::string(arg.data(), arg.size()));
+            /* In place: every view points into the buffer and is null terminated. */
+            if (arg.data() < buffer.data() || arg.data() + arg.size() >= buffer.data() + buffer.size() || arg.c_str()[arg.size()] != '\0') {
+                cout << "case " << i << ": argument " << a << " is not in place" << endl;
+                ++failures;
+            }
+        }
+        if (actual != cases[i].expected) {
+            cout << "case " << i << ": \"" << cases[i].input << "\" gave";
+            for (size_t a = 0; a < actual.size(); ++a) {
+                cout << " [" << actual[a] << "]";
+            }
+            cout << endl;
+            ++failures;
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(errors) / sizeof(errors[0]); ++i) {
+        std::vector<char> scratch;
+        try {
+            tokenizer.tokenize(errors[i], std::strlen(errors[i]), scratch);
+            cout << "\"" << errors[i] << "\" did not throw" << endl;
+            ++failures;
+        } catch (CommandLineError& ex) {
+            cout << "\"" << errors[i] << "\": CommandLineError: " << ex.what() << endl;
+        }
+    }
+
+    /* Feed a line straight to the parser. */
+    zoidbol::StdCommandLineParser parser;
+    zoidbol::StdCommandLineOption boolean_flag({"b", "boolean"}, "false", "Set a boolean flag.", zoidbol::StdCommandLineOption::NO_ARGUMENT);
+    zoidbol::StdCommandLineOption string_flag({"s", "string"}, "", "Set a flag to value.", zoidbol::StdCommandLineOption::ARGUMENT_REQUIRED);
+    zoidbol::StdCommandLineOption name_flag({"name"}, "", "A name.", zoidbol::StdCommandLineOption::ARGUMENT_REQUIRED);
+    parser.add_option(&boolean_flag).add_option(&string_flag).add_option(&name_flag);
+
+    const char* line = "-b --string 'hello world' --name=\"Hermes Conrad\" remaining \"arg ument\"";
+    std::vector<char> scratch;
+    tokenizer.tokenize(line, std::strlen(line), scratch);
+    tokenizer.parse(parser);
+
+    cout
+    << "boolean_flag.to_bool(): " << (boolean_flag.to_bool() ? "true" : "false") << endl
+    << "string_flag.to_string(): \"" << string_flag.to_string() << "\"" << endl
+    << "name_flag.to_string(): \"" << name_flag.to_string() << "\"" << endl
+    << "parser.arguments().size(): " << parser.arguments().size() << endl;
+
+    if (!boolean_flag.to_bool() || string_flag.to_string() != "hello world" || name_flag.to_string() != "Hermes Conrad"
+        || parser.arguments() != std::vector<std::string>({"remaining", "arg ument"})) {
+        cout << "parsed values do not match the line" << endl;
+        ++failures;
+    }
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}